@@ -4,10 +4,7 @@
 #include "Game.hpp"
 #include "types.hpp"
 
-Action::Action(ActionType type) : type(type) {}
-Action::Action(ActionType type, shared_ptr<Card> card) : type(type), targetCard(card) {}
-Action::Action(ActionType type, shared_ptr<ActivePokemon> targetPokemon) : type(type), targetPokemon(targetPokemon) {}
-Action::Action(ActionType type, Attack targetAttack) : type(type), targetAttack(targetAttack) {}
+Action::Action(ActionType type, int target, int attack) : type(type), target(target), attack(attack) {}
 
 // Define ANSI color codes
 #define COLOR_RESET   "\033[0m"
@@ -18,22 +15,23 @@ Action::Action(ActionType type, Attack targetAttack) : type(type), targetAttack(
 #define COLOR_MAGENTA "\033[35m"
 #define COLOR_CYAN    "\033[36m"
 
-void Action::display() const {
+void Action::display(const GameState& state) const {
+    const int player = state.currentPlayer;
     switch (type) {
     case ActionType::PLAY:
-        cout << COLOR_GREEN << "Play " << targetCard->name << COLOR_RESET << endl;
+        cout << COLOR_GREEN << "Play " << CardTable::getName(state.playerHands[player][target]) << COLOR_RESET << endl;
         break;
     case ActionType::ATTACK:
-        cout << COLOR_RED << "Attack with " << targetAttack.name << COLOR_RESET << endl;
+        cout << COLOR_RED << "Attack with " << CardTable::getAttack(state.slot(player, target).card, attack).name << COLOR_RESET << endl;
         break;
     case ActionType::END_TURN:
         cout << COLOR_YELLOW << "End turn" << COLOR_RESET << endl;
         break;
     case ActionType::ENERGY:
-        cout << COLOR_BLUE << "Attach energy to " << targetPokemon->pokemonCard->name << COLOR_RESET << endl;
+        cout << COLOR_BLUE << "Attach energy to " << CardTable::getName(state.slot(player, target).card) << COLOR_RESET << endl;
         break;
     case ActionType::BENCH:
-        cout << COLOR_GREEN << "Promote " << targetPokemon->pokemonCard->name << " to active spot" << COLOR_RESET << endl;
+        cout << COLOR_GREEN << "Promote " << CardTable::getName(state.slot(player, target).card) << " to active spot" << COLOR_RESET << endl;
         break;
     case ActionType::ROOT:
         cout << COLOR_MAGENTA << "ROOT CASE" << COLOR_RESET << endl;
@@ -41,9 +39,36 @@ void Action::display() const {
     }
 }
 
-ActionNode::ActionNode(shared_ptr<GameState> state, Action action) : state(state), action(action) {}
+ActionNode::ActionNode(const GameState& state, Action action) : state(state), action(action) {}
 
-string displayActionName(shared_ptr<ActionNode> node) {
+ActionNode* ActionTree::reset(const GameState& state) {
+    currentBlock = 0;
+    used = 0;
+    nodeCount = 0;
+    root = allocate(1);
+    *root = ActionNode(state, Action(ActionType::ROOT));
+    return root;
+}
+
+ActionNode* ActionTree::allocate(int count) {
+    // A range never spans two blocks, the rest of a block that cannot hold it stays unused
+    if (blocks.empty() || used + count > BLOCK_NODES) {
+        if (!blocks.empty()) {
+            currentBlock++;
+        }
+        if (currentBlock == blocks.size()) {
+            blocks.emplace_back(new ActionNode[BLOCK_NODES]);
+        }
+        used = 0;
+    }
+
+    ActionNode* nodes = &blocks[currentBlock][used];
+    used += count;
+    nodeCount += count;
+    return nodes;
+}
+
+string displayActionName(const ActionNode* node) {
     switch (node->action.type) {
     case ActionType::ROOT: return "Root";
     case ActionType::PLAY: return "Play";
@@ -55,45 +80,21 @@ string displayActionName(shared_ptr<ActionNode> node) {
     }
 }
 
-void applyAction(Game& game, const Action& action) {
+template <typename LogPolicy>
+void applyAction(BasicGame<LogPolicy>& game, const Action& action) {
     // Apply the action based on type
     switch (action.type) {
     case ActionType::PLAY:
-        game.playPokemon(game.getGameState()->currentPlayer, action.targetCard);
+        game.playPokemon(game.getGameState().currentPlayer, action.target);
         break;
     case ActionType::ATTACK:
-        game.performAttack(action.targetAttack);
+        game.performAttack(action.attack);
         break;
-    case ActionType::ENERGY: {
-        shared_ptr<ActivePokemon> newTargetPokemon = nullptr;
-
-        // Check active spot
-        auto activeSpot = game.getPlayerActiveSpot(game.getGameState()->currentPlayer);
-        if (activeSpot && activeSpot->pokemonCard == action.targetPokemon->pokemonCard) {
-            newTargetPokemon = activeSpot;
-        }
-
-        // Check bench spots
-        if (!newTargetPokemon) {
-            auto benchSpots = game.getPlayerBenchSpots(game.getGameState()->currentPlayer);
-            for (const auto& pokemon : benchSpots) {
-                if (pokemon->pokemonCard == action.targetPokemon->pokemonCard) {
-                    newTargetPokemon = pokemon;
-                    break;
-                }
-            }
-        }
-
-        if (newTargetPokemon) {
-            game.attachEnergy(newTargetPokemon);
-        }
-        else {
-            cerr << "Error: Target Pokemon not found in new state!" << endl;
-        }
+    case ActionType::ENERGY:
+        game.attachEnergy(action.target);
         break;
-    }
     case ActionType::BENCH:
-        game.playPokemonFromBench(game.getGameState()->currentPlayer, action.targetPokemon);
+        game.playPokemonFromBench(game.getGameState().currentPlayer, action.target);
         break;
     case ActionType::END_TURN:
         game.endTurn();
@@ -103,133 +104,110 @@ void applyAction(Game& game, const Action& action) {
     }
 }
 
-pair<shared_ptr<GameState>, vector<Action>> applyAction(const shared_ptr<GameState>& currentState, const Action& action) {
-    // Create a new game state from the current state
-    Game newGame(currentState, true); // Silent mode enabled   
-    
-    // Apply the action based on type
-    switch (action.type) {
-    case ActionType::PLAY:
-        newGame.playPokemon(currentState->currentPlayer, action.targetCard);
-        break;
-    case ActionType::ATTACK:
-        newGame.performAttack(action.targetAttack);
-        break;
-    case ActionType::ENERGY: {
-        // Find the corresponding targetPokemon in the new state
-        shared_ptr<ActivePokemon> newTargetPokemon = nullptr;
-
-        // Check active spot
-        auto activeSpot = newGame.getPlayerActiveSpot(currentState->currentPlayer);
-        if (activeSpot &&
-            activeSpot->pokemonCard ==
-            action.targetPokemon->pokemonCard) {
-            newTargetPokemon = activeSpot;
-        }
+template void applyAction(BasicGame<SilentPolicy>& game, const Action& action);
+template void applyAction(BasicGame<VerbosePolicy>& game, const Action& action);
 
-        // Check bench spots
-        if (!newTargetPokemon) {
-            auto benchSpots = newGame.getPlayerBenchSpots(currentState->currentPlayer);
-            for (const auto& pokemon : benchSpots) {
-                if (pokemon->pokemonCard == action.targetPokemon->pokemonCard) {
-                    newTargetPokemon = pokemon;
-                    break;
-                }
-            }
-        }
+pair<GameState, MoveList> applyAction(const GameState& currentState, const Action& action) {
+    // Create a new game state from the current state
+    Game newGame(currentState);
 
-        if (newTargetPokemon) {
-            newGame.attachEnergy(newTargetPokemon);
-        }
-        else {
-            cerr << "Error: Target Pokemon not found in new state!" << endl;
-        }
-        break;
-    }
-    case ActionType::END_TURN:
-        newGame.endTurn();
-        break;
-    case ActionType::ROOT:
-        break;
-    }
+    applyAction(newGame, action);
 
     // Generate the next set of valid actions from the new state
-    vector<Action> nextValidActions = newGame.getValidActions();
-    shared_ptr<GameState> newState = newGame.getGameState();    
-    
-    return { newState, nextValidActions };
+    MoveList nextValidActions = newGame.getValidActions();
+
+    return { newGame.getGameState(), nextValidActions };
 }
 
-vector<shared_ptr<ActionNode>> generateActionTree(const shared_ptr<GameState>& currentState, vector<Action> validActions) {
-    vector<shared_ptr<ActionNode>> actionNodes;
+// Takes the children of node from the tree, in the order of actions
+static ActionNode* addChildren(ActionTree& tree, ActionNode* node, const MoveList& actions) {
+    node->firstChild = actions.empty() ? nullptr : tree.allocate((int)actions.size());
+    node->childCount = (uint8_t)actions.size();
+    return node->firstChild;
+}
 
-    for (const Action& action : validActions) {
-        // Apply the action and get the new state and next valid actions
-        auto [nextState, nextValidActions] = applyAction(currentState, action);
+void generateActionTree(ActionTree& tree, ActionNode* node, const MoveList& validActions) {
+    ActionNode* children = addChildren(tree, node, validActions);
+    Game game(node->state);
 
-        // Create a new node for this action and add it to the tree
-        actionNodes.push_back(make_shared<ActionNode>(nextState, action));
+    for (int i = 0; i < (int)validActions.size(); i++) {
+        // Apply the action in place, keep a snapshot for the node and take it back
+        UndoRecord undo;
+        game.makeAction(validActions[i], undo);
+        children[i] = ActionNode(game.getGameState(), validActions[i]);
+        game.unmakeAction(undo);
     }
-
-    return actionNodes;
 }
 
-// Recursively build the action tree up to a specified depth
-void buildActionTree(shared_ptr<ActionNode> node, int maxTurns, int currentTurn, const vector<Action>& validActions) {
+// Expands the tree below node by walking a single game forwards and backwards
+static void expandActionTree(ActionTree& tree, Game& game, ActionNode* node, int maxTurns, int currentTurn, const MoveList& validActions, bool canonicalTurns) {
     // Base case: stop if we've reached the maximum number of turns
     if (currentTurn >= maxTurns) {
         return;
     }
 
     // Check if a forced action is required
-    bool forcedActionRequired = isForcedActionRequired(node->state);
+    bool forcedActionRequired = isForcedActionRequired(game.getGameState());
 
     if (forcedActionRequired) {
         // Generate only the actions that satisfy the forced action
-        vector<Action> forcedActions = getForcedActions(node->state);
+        MoveList forcedActions = getForcedActions(game.getGameState());
+        ActionNode* children = addChildren(tree, node, forcedActions);
 
-        for (const Action& action : forcedActions) {
-            //cout << "Turn " << currentTurn << ": Processing FORCED action ";
-            //action.display();
+        for (int i = 0; i < (int)forcedActions.size(); i++) {
+            // Apply the forced action in place
+            UndoRecord undo;
+            game.makeAction(forcedActions[i], undo);
 
-            // Apply the forced action to create a new game state
-            auto [newState, nextValidActions] = applyAction(node->state, action);
-
-            // Create a new child node for this forced action
-            auto child = make_shared<ActionNode>(newState, action);
-            node->children.push_back(child);
+            // Fill in the child node for this forced action
+            children[i] = ActionNode(game.getGameState(), forcedActions[i]);
 
             // Recursively build the tree for the next state
-            buildActionTree(child, maxTurns, currentTurn, nextValidActions);
+            expandActionTree(tree, game, &children[i], maxTurns, currentTurn, game.getValidActions(), canonicalTurns);
+
+            game.unmakeAction(undo);
         }
     }
     else {
         // No forced action required; process all valid actions
-        for (const Action& action : validActions) {
+        const MoveList actions = canonicalTurns ? getCanonicalActions(game) : validActions;
+        ActionNode* children = addChildren(tree, node, actions);
 
-            // Apply the action to create a new game state
-            auto [newState, nextValidActions] = applyAction(node->state, action);
+        for (int i = 0; i < (int)actions.size(); i++) {
+            const Action& action = actions[i];
 
-            // Create a new child node for this action
-            auto child = make_shared<ActionNode>(newState, action);
-            node->children.push_back(child);
+            // Apply the action in place
+            UndoRecord undo;
+            game.makeAction(action, undo);
+
+            // Fill in the child node for this action
+            children[i] = ActionNode(game.getGameState(), action);
 
             // If the action ends the turn, increment the turn counter
             int nextTurn = currentTurn;
-            if (action.type == ActionType::END_TURN) {
+            if (endsTurn(action)) {
                 nextTurn++;
             }
 
             // Recursively build the tree for the next state, but check if the game is over
-            if (!newState->gameOver) {
-                buildActionTree(child, maxTurns, nextTurn, nextValidActions);
+            if (!game.getGameState().gameOver) {
+                expandActionTree(tree, game, &children[i], maxTurns, nextTurn, game.getValidActions(), canonicalTurns);
             }
+
+            game.unmakeAction(undo);
         }
     }
 }
 
+// Recursively build the action tree up to a specified depth
+void buildActionTree(ActionTree& tree, ActionNode* node, int maxTurns, int currentTurn, const MoveList& validActions, bool canonicalTurns) {
+    // One game is walked through the whole tree instead of restoring a new one per child
+    Game game(canonicalTurns ? canonicalRoot(node->state) : node->state);
+    expandActionTree(tree, game, node, maxTurns, currentTurn, validActions, canonicalTurns);
+}
+
 // Overloaded function for calling display without knowing depth
-void displayActionTree(const shared_ptr<ActionNode>& node) {
+void displayActionTree(const ActionNode* node) {
     if (!node) return; // Handle empty tree
 
     // Find the maximum depth of the tree
@@ -239,30 +217,31 @@ void displayActionTree(const shared_ptr<ActionNode>& node) {
     displayActionTree(node, maxDepth, "");
 }
 
-void displayActionTree(const shared_ptr<ActionNode>& node, int depth, const string& prefix) {
+void displayActionTree(const ActionNode* node, int depth, const string& prefix, const GameState* parentState) {
     if (!node) return;
 
     // Display the current action with appropriate indentation and prefix
     cout << prefix;
     if (depth > 0) {
-        cout << (node->children.empty() ? "`-- " : "|-- ");
+        cout << (node->childCount == 0 ? "`-- " : "|-- ");
     }
-    node->action.display();
+    // The action is described against the state it was applied to, the root has none
+    node->action.display(parentState ? *parentState : node->state);
 
     // Recurse through the children
-    for (size_t i = 0; i < node->children.size(); ++i) {
-        bool isLastChild = (i == node->children.size() - 1);
+    for (int i = 0; i < node->childCount; ++i) {
+        bool isLastChild = (i == node->childCount - 1);
         string newPrefix = prefix + (depth > 0 ? (isLastChild ? "    " : "|   ") : "");
-        displayActionTree(node->children[i], depth + 1, newPrefix);
+        displayActionTree(&node->firstChild[i], depth + 1, newPrefix, &node->state);
     }
 }
 
-int findMaxDepth(const shared_ptr<ActionNode>& node) {
+int findMaxDepth(const ActionNode* node) {
     if (!node) return 0; // Base case: empty node has depth 0
 
     int maxChildDepth = 0;
-    for (const auto& child : node->children) {
-        int childDepth = findMaxDepth(child);
+    for (const ActionNode& child : node->children()) {
+        int childDepth = findMaxDepth(&child);
         if (childDepth > maxChildDepth) {
             maxChildDepth = childDepth;
         }
@@ -271,35 +250,70 @@ int findMaxDepth(const shared_ptr<ActionNode>& node) {
     return 1 + maxChildDepth; // Add 1 for the current node
 }
 
-bool isForcedActionRequired(const shared_ptr<GameState>& state) {
+bool isForcedActionRequired(const GameState& state) {
     // Check if the active spot is empty for the current player
-    return state->playerActiveSpots[state->currentPlayer] == nullptr;
+    return state.playerActiveSpots[state.currentPlayer].isEmpty();
 }
-vector<Action> getForcedActions(const shared_ptr<GameState>& state) {
-    vector<Action> forcedActions;
+MoveList getForcedActions(const GameState& state) {
+    MoveList forcedActions;
+    const int player = state.currentPlayer;
 
     // Scenario 1: At the start of the game (no Pokémon on bench)
-    if (state->playerBenchSpots[state->currentPlayer].empty()) {
-        // Get the current player's hand
-        const auto& hand = state->playerHands[state->currentPlayer];
-
+    if (state.playerBenchSize[player] == 0) {
         // Generate actions for playing a Basic Pokémon from hand to the active spot
-        for (const auto& card : hand) {
-            if (card->stage == 0) { // Ensure it's a Basic Pokémon
-                forcedActions.push_back(Action(ActionType::PLAY, card));
+        for (int i = 0; i < state.playerHandSize[player]; i++) {
+            if (CardTable::getStats(state.playerHands[player][i]).stage == 0) { // Ensure it's a Basic Pokémon
+                forcedActions.push_back(Action(ActionType::PLAY, i));
             }
         }
     }
     // Scenario 2: During the game (active Pokémon was knocked out)
     else {
-        // Get the current player's bench
-        const auto& bench = state->playerBenchSpots[state->currentPlayer];
-
         // Generate actions for promoting a Pokémon from the bench to the active spot
-        for (const auto& card : bench) {
-            forcedActions.push_back(Action(ActionType::BENCH, card));
+        for (int b = 0; b < state.playerBenchSize[player]; b++) {
+            forcedActions.push_back(Action(ActionType::BENCH, b + 1));
         }
     }
 
     return forcedActions;
+}
+
+MoveList getLegalActions(Game& game) {
+    const GameState& state = game.getGameState();
+    return isForcedActionRequired(state) ? getForcedActions(state) : game.getValidActions();
+}
+
+MoveList getCanonicalActions(Game& game) {
+    const GameState& state = game.getGameState();
+    if (isForcedActionRequired(state)) {
+        return getForcedActions(state);
+    }
+
+    const CardID* hand = state.playerHands[state.currentPlayer];
+    MoveList moves;
+    for (const Action& action : game.getValidActions()) {
+        if (action.type == ActionType::PLAY) {
+            // No cards are played once energy was attached, they are played before it instead
+            if (action.target < state.canonicalPlayFrom) {
+                continue;
+            }
+            // Benching a later copy of the same card leads to the same position. Different cards are all
+            // tried, the order they are benched in decides which one is promoted after a knockout
+            bool earlierCopy = false;
+            for (int i = 0; i < action.target && !earlierCopy; i++) {
+                earlierCopy = hand[i] == hand[action.target];
+            }
+            if (earlierCopy) {
+                continue;
+            }
+        }
+        moves.push_back(action);
+    }
+    return moves;
+}
+
+GameState canonicalRoot(const GameState& state) {
+    GameState root = state;
+    root.canonicalPlayFrom = 0;
+    return root;
 }
\ No newline at end of file
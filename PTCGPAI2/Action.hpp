@@ -2,55 +2,140 @@
 #define ACTION_HPP
 
 #include <memory>
+#include <span>
+#include <type_traits>
 #include <vector>
 
 #include "types.hpp"
+#include "GameState.hpp"
 
-// Forward declaration to avoid circular dependency
-class ActivePokemon;
-struct GameState;
-class Card;
+// Forward declarations to avoid circular dependency
 class Game;
+template <typename LogPolicy>
+class BasicGame;
 
-enum class ActionType { PLAY, ATTACK, END_TURN, ENERGY, ROOT, BENCH };
+enum class ActionType : uint8_t { PLAY, ATTACK, END_TURN, ENERGY, ROOT, BENCH };
 
+// Packed 16-bit move, cheap to copy into move lists and tree nodes
 struct Action {
-    ActionType type;    
-    std::shared_ptr<Card> targetCard;  // for use with PLAY
-    std::shared_ptr<ActivePokemon> targetPokemon; // for use with ENERGY, BENCH
-    Attack targetAttack; // for use with ATTACK
+    ActionType type;
+    uint8_t target : 5;  // hand index for PLAY, slot number for ENERGY, BENCH and ATTACK
+    uint8_t attack : 3;  // attack index, for use with ATTACK
 
-    Action(ActionType type);
-    Action(ActionType type, std::shared_ptr<Card> card);
-    Action(ActionType type, std::shared_ptr<ActivePokemon> targetPokemon);
-    Action(ActionType type, Attack targetAttack);
+    Action() = default;
+    Action(ActionType type, int target = 0, int attack = 0);
 
-    void display() const;
+    bool operator==(const Action& other) const {
+        return type == other.type && target == other.target && attack == other.attack;
+    }
+    bool operator!=(const Action& other) const { return !(*this == other); }
+
+    // Display the action as applied to the given state
+    void display(const GameState& state) const;
+};
+
+static_assert(sizeof(Action) == 2, "Action must stay packed in 16 bits");
+
+// Attacks end the turn just like END_TURN does
+inline bool endsTurn(const Action& action) {
+    return action.type == ActionType::END_TURN || action.type == ActionType::ATTACK;
+}
+
+// Upper bound on the moves of one position: a full hand, every energy target, every attack and END_TURN
+constexpr int MAX_MOVES = MAX_HAND_SIZE + NUM_POKEMON_SLOTS + MAX_CARD_ATTACKS + 1;
+
+// Fixed-capacity move list that lives on the stack
+struct MoveList {
+    Action moves[MAX_MOVES];
+    uint8_t count = 0;
+
+    void push_back(Action action) { moves[count++] = action; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    Action& operator[](size_t i) { return moves[i]; }
+    const Action& operator[](size_t i) const { return moves[i]; }
+    Action* begin() { return moves; }
+    Action* end() { return moves + count; }
+    const Action* begin() const { return moves; }
+    const Action* end() const { return moves + count; }
 };
 
+// A node of the action tree. Nodes live in an ActionTree and hold no owning pointers
 struct ActionNode {
-    std::shared_ptr<GameState> state;
+    GameState state;
     Action action;
-    std::vector<std::shared_ptr<ActionNode>> children;
+    uint8_t childCount = 0;
+    ActionNode* firstChild = nullptr;  // The children sit next to each other in the tree's arena
+
+    ActionNode() = default;
+    ActionNode(const GameState& state, Action action);
 
-    ActionNode(std::shared_ptr<GameState> state, Action action);
+    std::span<ActionNode> children() const { return { firstChild, childCount }; }
 };
 
-string displayActionName(std::shared_ptr<ActionNode> node);
+static_assert(std::is_trivially_destructible_v<ActionNode>, "Releasing a tree must not have to visit its nodes");
+
+// Arena that owns the nodes of one action tree. Nodes are bump-allocated from blocks that are kept
+// when the tree is reset, so rebuilding a tree allocates nothing once the blocks exist and releasing
+// one is O(1). Not thread-safe, every search thread builds its own tree
+class ActionTree {
+public:
+    ActionTree() = default;
+    ActionTree(const ActionTree&) = delete;
+    ActionTree& operator=(const ActionTree&) = delete;
+
+    // Releases every node and starts a new tree with a root for state. Nodes handed out before are invalid afterwards
+    ActionNode* reset(const GameState& state);
+
+    // Takes count nodes that lie next to each other, for the children of one node
+    ActionNode* allocate(int count);
+
+    ActionNode* getRoot() const { return root; }
+    size_t size() const { return nodeCount; }
+
+private:
+    static constexpr size_t BLOCK_NODES = 4096;
+
+    std::vector<std::unique_ptr<ActionNode[]>> blocks;
+    size_t currentBlock = 0;
+    size_t used = 0;        // Nodes taken from the current block
+    size_t nodeCount = 0;
+    ActionNode* root = nullptr;
+};
+
+string displayActionName(const ActionNode* node);
+
+// Plays the action on the game, search and interactive games alike
+template <typename LogPolicy>
+void applyAction(BasicGame<LogPolicy>& game, const Action& action);
+std::pair<GameState, MoveList> applyAction(const GameState& currentState, const Action& action);
+
+// Adds one child per valid action to node
+void generateActionTree(ActionTree& tree, ActionNode* node, const MoveList& validActions);
+
+// With canonicalTurns every end-of-turn outcome gets one branch instead of one per ordering (see getCanonicalActions)
+void buildActionTree(ActionTree& tree, ActionNode* node, int maxTurns, int currentTurn, const MoveList& validActions, bool canonicalTurns = false);
 
-void applyAction(Game& game, const Action& action);
-std::pair<std::shared_ptr<GameState>, std::vector<Action>> applyAction(const std::shared_ptr<GameState>& currentState, const Action& action);
+void displayActionTree(const ActionNode* node);
+void displayActionTree(const ActionNode* node, int depth, const string& prefix = "", const GameState* parentState = nullptr);
 
-std::vector<std::shared_ptr<ActionNode>> generateActionTree(const std::shared_ptr<GameState>& currentState, std::vector<Action> validActions);
+int findMaxDepth(const ActionNode* node);
 
-void buildActionTree(std::shared_ptr<ActionNode> node, int maxTurns, int currentTurn, const std::vector<Action>& validActions);
+bool isForcedActionRequired(const GameState& state);
+MoveList getForcedActions(const GameState& state);
 
-void displayActionTree(const shared_ptr<ActionNode>& node);
-void displayActionTree(const std::shared_ptr<ActionNode>& node, int depth, const string& prefix = "");
+// Moves of the game's position as buildActionTree generates them, only the forced ones when one is required
+MoveList getLegalActions(Game& game);
 
-int findMaxDepth(const shared_ptr<ActionNode>& node);
+// Legal moves in canonical turn order: forced actions, then benched cards with one copy of each card per choice,
+// then at most one energy, then an attack or END_TURN. Every bench order is still tried, as slot 1 is the one
+// promoted after a knockout, but energy is only attached after the last card is played. Energy and plays are
+// independent, so every end-of-turn outcome is still reached. Only the orderings that differ in when the energy
+// was attached or in which copy of a card was benched are removed. Large turns shrink about 2-3x, most far less
+MoveList getCanonicalActions(Game& game);
 
-bool isForcedActionRequired(const shared_ptr<GameState>& state);
-vector<Action> getForcedActions(const shared_ptr<GameState>& state);
+// The position with its canonical order restriction cleared. A search can start after energy was attached by a
+// move it did not choose, such as a human one, and the root must still be offered every card play
+GameState canonicalRoot(const GameState& state);
 
 #endif // ACTION_HPP
\ No newline at end of file
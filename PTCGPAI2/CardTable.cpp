@@ -0,0 +1,56 @@
+#include "CardTable.hpp"
+#include "deck.hpp"
+#include "Zobrist.hpp"
+
+#include <stdexcept>
+
+void CardTable::build(const CardCollection& collection) {
+    hotStats.clear();
+    coldInfo.clear();
+    hotStats.resize(collection.cards.size());
+    coldInfo.resize(collection.cards.size());
+
+    maxHP = 0;
+    for (const Card& card : collection.cards) {
+        // IDs are handed out by the collection in insertion order, so they index the table directly
+        if (card.cardID < 0 || card.cardID >= (int)collection.cards.size()) {
+            throw std::invalid_argument("Card " + card.name + " has no valid card ID");
+        }
+
+        CardStats& stats = hotStats[card.cardID];
+        CardInfo& info = coldInfo[card.cardID];
+
+        stats.hp = (int16_t)card.hp;
+        maxHP = max(maxHP, card.hp);
+        stats.type = card.type;
+        stats.weakness = card.weakness;
+        stats.retreatCost = (uint8_t)card.retreatCost;
+        stats.stage = (uint8_t)card.stage;
+        stats.attackCount = (uint8_t)min<size_t>(card.attacks.size(), MAX_CARD_ATTACKS);
+        info.name = card.name;
+
+        for (int a = 0; a < stats.attackCount; a++) {
+            const Attack& attack = card.attacks[a];
+            AttackStats& attackStats = stats.attacks[a];
+
+            attackStats.damage = (int16_t)attack.damage;
+            info.attacks[a] = attack;
+
+            // Precompile the requirements into the packed energy layout
+            for (const EnergyRequirement& requirement : attack.energyRequirement) {
+                if (requirement.type == 'X') {
+                    attackStats.cost.colorless += (uint8_t)requirement.amount;
+                }
+                else if (energyTypeIndex(requirement.type) >= 0) {
+                    attackStats.cost.typed += energyUnit(requirement.type) * requirement.amount;
+                }
+                else {
+                    throw std::invalid_argument("Attack " + attack.name + " requires unknown energy " + string(1, requirement.type));
+                }
+                attackStats.cost.total += (uint8_t)requirement.amount;
+            }
+        }
+    }
+
+    Zobrist::build(collection.cards.size(), maxHP);
+}
@@ -0,0 +1,65 @@
+#ifndef CARDTABLE_HPP
+#define CARDTABLE_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "types.hpp"
+#include "energy.hpp"
+
+// Forward declaration to avoid circular dependency
+class CardCollection;
+
+using namespace std;
+
+// Dense index of a card in the card table
+using CardID = uint16_t;
+
+constexpr int MAX_CARD_ATTACKS = 2;       // The CSV holds up to 2 attacks per card
+
+// Hot data of an attack, everything the rules engine needs to resolve it
+struct AttackStats {
+    EnergyCost cost;
+    int16_t damage = 0;
+};
+
+// Hot data of a card, laid out so one card fits in a single cache line
+struct CardStats {
+    int16_t hp = 0;
+    char type = 0;
+    char weakness = 0;
+    uint8_t retreatCost = 0;
+    uint8_t stage = 0;
+    uint8_t attackCount = 0;
+    AttackStats attacks[MAX_CARD_ATTACKS];
+};
+
+static_assert(sizeof(CardStats) <= 64, "CardStats must fit in one cache line");
+
+// Cold data of a card: names and the full attack descriptions used for display
+struct CardInfo {
+    string name;
+    Attack attacks[MAX_CARD_ATTACKS];
+};
+
+// Global read-only card table, built once from the card collection
+class CardTable {
+public:
+    // Interns every card of the collection under its card ID
+    static void build(const CardCollection& collection);
+
+    static const CardStats& getStats(CardID id) { return hotStats[id]; }
+    static const CardInfo& getInfo(CardID id) { return coldInfo[id]; }
+    static const string& getName(CardID id) { return coldInfo[id].name; }
+    static const Attack& getAttack(CardID id, int attack) { return coldInfo[id].attacks[attack]; }
+    static size_t size() { return hotStats.size(); }
+    static int getMaxHP() { return maxHP; }  // Highest HP of any card
+
+private:
+    static inline vector<CardStats> hotStats;
+    static inline vector<CardInfo> coldInfo;
+    static inline int maxHP = 0;
+};
+
+#endif // CARDTABLE_HPP
@@ -0,0 +1,118 @@
+#include "Determinization.hpp"
+#include "Game.hpp"
+#include "Zobrist.hpp"
+#include "TranspositionTable.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <thread>
+#include <vector>
+
+Determinizer::Determinizer(const GameState& state, int player)
+    : base(state), player(player) {
+    const int opponent = 1 - player;
+    for (int i = 0; i < state.playerHandSize[opponent]; i++) {
+        opponentPool[opponentPoolSize++] = state.playerHands[opponent][i];
+    }
+    for (int i = 0; i < state.gameDeckSize[opponent]; i++) {
+        opponentPool[opponentPoolSize++] = state.gameDecks[opponent][i];
+    }
+}
+
+void Determinizer::sample(GameState& out, Rng& rng) const {
+    out = base;
+    const int opponent = 1 - player;
+
+    // Deal the opponent's unseen cards back into a hand and a deck of the same sizes
+    CardID pool[MAX_UNSEEN_CARDS];
+    copy(opponentPool, opponentPool + opponentPoolSize, pool);
+    rng.shuffle(pool, opponentPoolSize);
+    const int handSize = out.playerHandSize[opponent];
+    copy(pool, pool + handSize, out.playerHands[opponent]);
+    copy(pool + handSize, pool + opponentPoolSize, out.gameDecks[opponent]);
+
+    // The player knows what is left in their own deck, but not the order
+    rng.shuffle(out.gameDecks[player], out.gameDeckSize[player]);
+
+    out.rng = rng.split();
+
+    out.zobristKey = Zobrist::computeKey(out);
+}
+
+constexpr size_t DETERMINIZED_TABLE_MB = 4;  // Transposition table of each search thread
+
+Action findBestActionDeterminized(const GameState& state, const DeterminizedSearchOptions& options) {
+    Game rootGame(state);
+    MoveList rootMoves = getLegalActions(rootGame);
+    if (rootMoves.size() <= 1) {
+        return rootMoves.empty() ? Action(ActionType::END_TURN) : rootMoves[0];
+    }
+
+    const Determinizer determinizer(state, state.currentPlayer);
+
+    // Votes and summed values per root move, indexed like rootMoves
+    atomic<int> votes[MAX_MOVES] = {};
+    atomic<int64_t> values[MAX_MOVES] = {};
+
+    // Every sample gets an equal slice of the budgets, so the first ones cannot use them up and leave the
+    // vote to a few. Samples run options.threads at a time, so a time slice lasts one round of them
+    const int threadCount = max(1, options.threads);
+    const int rounds = (options.samples + threadCount - 1) / threadCount;
+    const int64_t sampleTimeMs = options.limits.timeLimitMs > 0 ? max<int64_t>(1, options.limits.timeLimitMs / max(1, rounds)) : 0;
+    const uint64_t sampleNodes = options.limits.maxNodes > 0 ? max<uint64_t>(1, options.limits.maxNodes / max(1, options.samples)) : 0;
+    const auto deadline = chrono::steady_clock::now() + chrono::milliseconds(options.limits.timeLimitMs);
+    atomic<int> nextSample(0);
+
+    auto worker = [&](Rng rng) {
+        TranspositionTable table(DETERMINIZED_TABLE_MB);
+        GameState sampled;
+
+        for (int s = nextSample++; s < options.samples; s = nextSample++) {
+            SearchLimits limits = options.limits;
+            limits.maxNodes = sampleNodes;
+            if (options.limits.timeLimitMs > 0) {
+                const int64_t remainingMs = chrono::duration_cast<chrono::milliseconds>(deadline - chrono::steady_clock::now()).count();
+                if (remainingMs <= 0) {
+                    return;
+                }
+                limits.timeLimitMs = min(sampleTimeMs, remainingMs);
+            }
+
+            determinizer.sample(sampled, rng);
+            table.clear();
+            SearchResult result = iterativeDeepening(sampled, limits, table);
+
+            // A sample whose first iteration did not finish has no opinion
+            if (result.depth == 0) {
+                continue;
+            }
+            for (int m = 0; m < (int)rootMoves.size(); m++) {
+                if (rootMoves[m] == result.bestAction) {
+                    votes[m]++;
+                    values[m] += result.value;
+                    break;
+                }
+            }
+        }
+    };
+
+    Rng rng = options.seed != 0 ? Rng(options.seed) : Rng::fromRandomDevice();
+    vector<thread> threads;
+    for (int t = 1; t < options.threads; t++) {
+        threads.emplace_back(worker, rng.split());
+    }
+    worker(rng.split());
+    for (thread& t : threads) {
+        t.join();
+    }
+
+    int best = 0;
+    for (int m = 1; m < (int)rootMoves.size(); m++) {
+        if (votes[m] > votes[best] || (votes[m] == votes[best] && values[m] > values[best])) {
+            best = m;
+        }
+    }
+    return rootMoves[best];
+}
@@ -0,0 +1,41 @@
+#ifndef DETERMINIZATION_HPP
+#define DETERMINIZATION_HPP
+
+#include "GameState.hpp"
+#include "Action.hpp"
+#include "aiFunctions.hpp"
+
+using namespace std;
+
+constexpr int MAX_UNSEEN_CARDS = MAX_HAND_SIZE + MAX_GAME_DECK_SIZE;
+
+// Samples the cards a player cannot see: the opponent's hand and the order of both decks.
+// The opponent's hand and deck are redealt from their combined cards, which is exactly their deck list
+// minus the cards in play, so every sample is consistent with what the player has seen
+class Determinizer {
+public:
+    Determinizer(const GameState& state, int player);
+
+    // Writes a new determinization into out. Works on fixed-size arrays and never allocates.
+    // The energy still to come is hidden too, so the sample gets a generator of its own
+    void sample(GameState& out, Rng& rng) const;
+
+private:
+    GameState base;
+    int player;
+    CardID opponentPool[MAX_UNSEEN_CARDS];
+    uint8_t opponentPoolSize = 0;
+};
+
+struct DeterminizedSearchOptions {
+    int samples = 16;     // Determinizations searched per move
+    int threads = 1;      // Determinizations searched at the same time
+    SearchLimits limits;  // Limits of each search, except maxNodes and timeLimitMs which are split evenly between the samples
+    uint64_t seed = 0;    // Seed of the samples, 0 seeds from the system
+};
+
+// Information-set search: searches sampled determinizations of the hidden cards for the side to move
+// and plays the move most of them chose. Ties go to the higher summed value
+Action findBestActionDeterminized(const GameState& state, const DeterminizedSearchOptions& options);
+
+#endif // DETERMINIZATION_HPP
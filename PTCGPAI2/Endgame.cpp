@@ -0,0 +1,320 @@
+#include "Endgame.hpp"
+#include "Game.hpp"
+#include "CardTable.hpp"
+#include "aiFunctions.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <fstream>
+
+// File layout: magic, format version, card count, entry count, then per entry the key length, the key and
+// the packed result
+constexpr uint32_t ENDGAME_FILE_MAGIC = 0x47454750;  // "PGEG"
+constexpr uint32_t ENDGAME_FILE_VERSION = 3;  // 1 merged positions that only differed in bench order, 2 had hashed keys
+
+constexpr uint64_t ENDGAME_CHECK_INTERVAL = 1024;  // Positions between two checks of the time and stop limits
+
+bool EndgameTable::qualifies(const GameState& state) {
+    if (state.gameOver) {
+        return false;
+    }
+
+    int pokemon = 0;
+    for (int player = 0; player < 2; player++) {
+        pokemon += !state.playerActiveSpots[player].isEmpty() + state.playerBenchSize[player] + state.playerHandSize[player];
+    }
+    return pokemon <= MAX_ENDGAME_POKEMON;
+}
+
+static void appendCard(string& key, CardID card) {
+    key.push_back((char)(card & 0xFF));
+    key.push_back((char)(card >> 8));
+}
+
+// Card and HP, then a mask of the energy types attached and the count of each of them
+static void appendPokemon(string& key, const ActivePokemon& pokemon) {
+    appendCard(key, pokemon.card);
+    key.push_back((char)(pokemon.currentHP & 0xFF));
+    key.push_back((char)((uint16_t)pokemon.currentHP >> 8));
+    uint8_t mask = 0;
+    for (int e = 0; e < NUM_ENERGY_TYPES; e++) {
+        mask |= (uint8_t)(((pokemon.currentEnergy >> (8 * e)) & 0xFF) != 0) << e;
+    }
+    key.push_back((char)mask);
+    for (int e = 0; e < NUM_ENERGY_TYPES; e++) {
+        if (mask & (1 << e)) {
+            key.push_back((char)((pokemon.currentEnergy >> (8 * e)) & 0xFF));
+        }
+    }
+}
+
+string EndgameTable::canonicalKey(const GameState& state) {
+    string key;
+    key.reserve(64);
+
+    // The player to move is encoded first, so both players share the entries of mirrored positions
+    for (int side = 0; side < 2; side++) {
+        const int player = side == 0 ? state.currentPlayer : 1 - state.currentPlayer;
+
+        key.push_back((char)state.playerPoints[player]);
+        key.push_back(state.playerAvailableEnergy[player]);
+
+        // Energy is drawn uniformly from the types, so their order does not matter
+        char energyTypes[MAX_DECK_ENERGY_TYPES];
+        const int energyTypeCount = min<int>(state.playerEnergyTypeCount[player], MAX_DECK_ENERGY_TYPES);
+        copy(state.playerEnergyTypes[player], state.playerEnergyTypes[player] + energyTypeCount, energyTypes);
+        sort(energyTypes, energyTypes + energyTypeCount);
+        key.push_back((char)energyTypeCount);
+        key.append(energyTypes, energyTypeCount);
+
+        appendPokemon(key, state.playerActiveSpots[player]);
+
+        // The bench is kept in slot order: a knockout always promotes slot 1, so the order can decide the game
+        const int benchSize = state.playerBenchSize[player];
+        key.push_back((char)benchSize);
+        for (int b = 0; b < benchSize; b++) {
+            appendPokemon(key, state.playerBenchSpots[player][b]);
+        }
+
+        CardID hand[MAX_HAND_SIZE];
+        const int handSize = state.playerHandSize[player];
+        copy(state.playerHands[player], state.playerHands[player] + handSize, hand);
+        sort(hand, hand + handSize);
+        key.push_back((char)handSize);
+        for (int i = 0; i < handSize; i++) {
+            appendCard(key, hand[i]);
+        }
+    }
+    return key;
+}
+
+static EndgameResult opposite(EndgameResult result) {
+    switch (result) {
+    case EndgameResult::WIN: return EndgameResult::LOSS;
+    case EndgameResult::LOSS: return EndgameResult::WIN;
+    default: return EndgameResult::UNKNOWN;
+    }
+}
+
+// Result of a move for the player making it
+EndgameEntry EndgameTable::searchMove(Game& game, const Action& action, int turnsLeft) {
+    UndoRecord undo;
+    if (!endsTurn(action)) {
+        game.makeAction(action, undo);
+        EndgameEntry entry = search(game, turnsLeft, nullptr);
+        game.unmakeAction(undo);
+        return entry;
+    }
+
+    // The turn ends: the move only counts as proven if it holds for every energy the opponent can get
+    const int opponent = 1 - game.getGameState().currentPlayer;
+    const int outcomes = max<int>(1, game.getGameState().playerEnergyTypeCount[opponent]);
+    EndgameEntry combined;
+    for (int i = 0; i < outcomes; i++) {
+        if (game.getGameState().playerEnergyTypeCount[opponent] > 0) {
+            game.setEnergyOutcome(i);
+        }
+        game.makeAction(action, undo);
+        const bool gameOver = game.getGameState().gameOver;
+        EndgameEntry child = search(game, turnsLeft - 1, nullptr);
+        game.unmakeAction(undo);
+
+        // The opponent moves next, so their result is the mover's opposite
+        const EndgameResult result = opposite(child.result);
+        if (i == 0) {
+            combined.result = result;
+        }
+        else if (result != combined.result) {
+            combined.result = EndgameResult::UNKNOWN;
+        }
+        if (combined.result == EndgameResult::UNKNOWN) {
+            return {};
+        }
+        combined.distance = max<int>(combined.distance, child.distance + 1);
+
+        // Energy cannot matter once the game is over
+        if (gameOver) {
+            break;
+        }
+    }
+    return combined;
+}
+
+// Function to check the limits of the solve, once one runs out every search still running unwinds
+bool EndgameTable::outOfBudget() {
+    if (budget.aborted) {
+        return true;
+    }
+    budget.nodes++;
+    if (budget.maxNodes > 0 && budget.nodes >= budget.maxNodes) {
+        budget.aborted = true;
+    }
+    else if (budget.nodes % ENDGAME_CHECK_INTERVAL == 0) {
+        budget.aborted = (budget.stop != nullptr && budget.stop->load(memory_order_relaxed))
+            || (budget.hasDeadline && chrono::steady_clock::now() >= budget.deadline);
+    }
+    return budget.aborted;
+}
+
+// Unknown results are cheap to find again, proven ones are only dropped if they alone fill the table
+void EndgameTable::makeRoom() {
+    for (auto it = entries.begin(); it != entries.end();) {
+        it = it->second.result == EndgameResult::UNKNOWN ? entries.erase(it) : next(it);
+    }
+    if (entries.size() > maxEntries / 2) {
+        entries.clear();
+    }
+}
+
+EndgameEntry EndgameTable::search(Game& game, int turnsLeft, Action* bestMove) {
+    const GameState& state = game.getGameState();
+    if (outOfBudget()) {
+        return {};
+    }
+    if (state.gameOver) {
+        EndgameEntry entry;
+        entry.result = state.winner == state.currentPlayer ? EndgameResult::WIN : EndgameResult::LOSS;
+        return entry;
+    }
+    if (turnsLeft <= 0) {
+        return {};
+    }
+
+    // The root is searched even when stored, to find its move
+    const string key = canonicalKey(state);
+    if (bestMove == nullptr) {
+        auto stored = entries.find(key);
+        if (stored != entries.end()) {
+            const EndgameEntry& entry = stored->second;
+            if (entry.result == EndgameResult::UNKNOWN ? entry.horizon >= turnsLeft : entry.distance <= turnsLeft) {
+                return entry;
+            }
+        }
+    }
+
+    MoveList moves = getLegalActions(game);
+    EndgameEntry best;
+    bool allLost = !moves.empty();
+    int fastestWin = INT_MAX;
+    int longestLoss = -1;
+    for (const Action& action : moves) {
+        EndgameEntry entry = searchMove(game, action, turnsLeft);
+        if (budget.aborted) {
+            return {};
+        }
+        if (entry.result == EndgameResult::WIN && entry.distance < fastestWin) {
+            fastestWin = entry.distance;
+            if (bestMove != nullptr) {
+                *bestMove = action;
+            }
+        }
+        if (entry.result != EndgameResult::LOSS) {
+            allLost = false;
+        }
+        else if (fastestWin == INT_MAX && entry.distance > longestLoss) {
+            longestLoss = entry.distance;
+            if (bestMove != nullptr) {
+                *bestMove = action;
+            }
+        }
+    }
+
+    if (fastestWin != INT_MAX) {
+        best.result = EndgameResult::WIN;
+        best.distance = (uint8_t)fastestWin;
+    }
+    else if (allLost) {
+        best.result = EndgameResult::LOSS;
+        best.distance = (uint8_t)longestLoss;
+    }
+    best.horizon = (uint8_t)turnsLeft;
+    if (entries.size() >= maxEntries) {
+        makeRoom();
+    }
+    entries[key] = best;
+    return best;
+}
+
+EndgameEntry EndgameTable::solve(const GameState& state, int maxTurns, Action* bestMove) {
+    budget = Budget();
+    return run(state, maxTurns, bestMove);
+}
+
+EndgameEntry EndgameTable::solve(const GameState& state, const SearchLimits& limits, Action* bestMove) {
+    budget = Budget();
+    budget.maxNodes = limits.maxNodes;
+    budget.stop = limits.stop;
+    if (limits.timeLimitMs > 0) {
+        budget.hasDeadline = true;
+        budget.deadline = chrono::steady_clock::now() + chrono::milliseconds(limits.timeLimitMs);
+    }
+    return run(state, limits.endgameTurns, bestMove);
+}
+
+EndgameEntry EndgameTable::run(const GameState& state, int maxTurns, Action* bestMove) {
+    Game game(state, true);
+    Action move = Action(ActionType::END_TURN);
+    EndgameEntry entry = search(game, maxTurns, &move);
+    if (bestMove != nullptr) {
+        *bestMove = move;
+    }
+    return entry;
+}
+
+bool EndgameTable::load(const string& path) {
+    ifstream file(path, ios::binary);
+    if (!file) {
+        return false;
+    }
+
+    uint32_t header[3];
+    uint64_t count = 0;
+    file.read(reinterpret_cast<char*>(header), sizeof(header));
+    file.read(reinterpret_cast<char*>(&count), sizeof(count));
+    // Keys hold card IDs, which are only stable for the same card table
+    if (!file || header[0] != ENDGAME_FILE_MAGIC || header[1] != ENDGAME_FILE_VERSION || header[2] != CardTable::size()) {
+        return false;
+    }
+
+    entries.reserve(entries.size() + count);
+    string key;
+    for (uint64_t i = 0; i < count; i++) {
+        uint16_t keyLength = 0;
+        uint8_t record[3];
+        file.read(reinterpret_cast<char*>(&keyLength), sizeof(keyLength));
+        key.resize(keyLength);
+        file.read(key.data(), keyLength);
+        file.read(reinterpret_cast<char*>(record), sizeof(record));
+        if (!file) {
+            return false;
+        }
+        entries[key] = { (EndgameResult)record[0], record[1], record[2] };
+    }
+    return true;
+}
+
+bool EndgameTable::save(const string& path) const {
+    ofstream file(path, ios::binary | ios::trunc);
+    if (!file) {
+        return false;
+    }
+
+    const uint32_t header[3] = { ENDGAME_FILE_MAGIC, ENDGAME_FILE_VERSION, (uint32_t)CardTable::size() };
+    uint64_t count = 0;
+    for (const auto& [key, entry] : entries) {
+        count += entry.result != EndgameResult::UNKNOWN;
+    }
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    for (const auto& [key, entry] : entries) {
+        if (entry.result == EndgameResult::UNKNOWN) {
+            continue;
+        }
+        const uint16_t keyLength = (uint16_t)key.size();
+        const uint8_t record[3] = { (uint8_t)entry.result, entry.distance, entry.horizon };
+        file.write(reinterpret_cast<const char*>(&keyLength), sizeof(keyLength));
+        file.write(key.data(), keyLength);
+        file.write(reinterpret_cast<const char*>(record), sizeof(record));
+    }
+    return (bool)file;
+}
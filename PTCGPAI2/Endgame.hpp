@@ -0,0 +1,95 @@
+#ifndef ENDGAME_HPP
+#define ENDGAME_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include "GameState.hpp"
+#include "Action.hpp"
+#include "aiFunctions.hpp"
+
+using namespace std;
+
+class Game;
+
+// Positions with at most this many Pokemon in play and in hand, counting both players, are solved exactly
+constexpr int MAX_ENDGAME_POKEMON = 7;
+
+// Entries a table holds by default, about 80 MB with keys of 50-60 bytes
+constexpr size_t MAX_ENDGAME_ENTRIES = 1 << 19;
+
+enum class EndgameResult : uint8_t {
+    UNKNOWN,  // Neither player can force a win within the turns searched
+    WIN,      // The player to move wins whatever energy is generated
+    LOSS      // The opponent wins whatever energy is generated
+};
+
+// Proven result of a position for the player to move
+struct EndgameEntry {
+    EndgameResult result = EndgameResult::UNKNOWN;
+    uint8_t distance = 0;  // Turns until the game ends: the fastest forced win, or the longest the loser can hold out
+    uint8_t horizon = 0;   // Turns searched, an UNKNOWN result only holds up to this many turns
+};
+
+// Exact solver for positions with few Pokemon left. Searches every move and every energy outcome with the
+// Game rules engine and memoizes the results by canonical position, so positions reached by different
+// move orders, or with the players' hands in a different order, are solved once.
+// There are no draws in the rules, so a position is either proven or unknown within the turns searched.
+// Not thread-safe, every search thread uses its own table
+class EndgameTable {
+public:
+    // Once the table holds maxEntries entries the unknown ones are dropped, and the proven ones too if they
+    // still fill more than half of it
+    explicit EndgameTable(size_t maxEntries = MAX_ENDGAME_ENTRIES) : maxEntries(maxEntries) {}
+
+    // Whether the position is small enough to be solved
+    static bool qualifies(const GameState& state);
+
+    // Exact packed encoding of the position as seen by the player to move. Ignores everything that cannot
+    // change the result: the order of the hands, the draw piles and the damage statistics. Positions only
+    // share a key if they play the same, so a stored proof is never taken for another position
+    static string canonicalKey(const GameState& state);
+
+    // Solves the position up to maxTurns turns ahead. bestMove receives the fastest winning move,
+    // or the move that holds out longest when the position is lost
+    EndgameEntry solve(const GameState& state, int maxTurns, Action* bestMove = nullptr);
+    // Solves up to limits.endgameTurns turns ahead within the time, node and stop limits of a search.
+    // Gives up with UNKNOWN as soon as one runs out, nothing found by the unfinished solve is stored
+    EndgameEntry solve(const GameState& state, const SearchLimits& limits, Action* bestMove = nullptr);
+    // Positions visited by the last solve
+    uint64_t nodes() const { return budget.nodes; }
+
+    // Reads or writes the table, returns false if the file cannot be used. Only proven results are written,
+    // unknown ones depend on how deep the search went
+    bool load(const string& path);
+    bool save(const string& path) const;
+
+    void clear() { entries.clear(); }
+    size_t size() const { return entries.size(); }
+
+private:
+    // Limits of the running solve, zero means no limit
+    struct Budget {
+        uint64_t nodes = 0;
+        uint64_t maxNodes = 0;
+        bool hasDeadline = false;
+        chrono::steady_clock::time_point deadline;
+        const atomic<bool>* stop = nullptr;
+        bool aborted = false;
+    };
+
+    unordered_map<string, EndgameEntry> entries;
+    size_t maxEntries;
+    Budget budget;
+
+    bool outOfBudget();
+    void makeRoom();
+    EndgameEntry run(const GameState& state, int maxTurns, Action* bestMove);
+    EndgameEntry search(Game& game, int turnsLeft, Action* bestMove);
+    EndgameEntry searchMove(Game& game, const Action& action, int turnsLeft);
+};
+
+#endif // ENDGAME_HPP
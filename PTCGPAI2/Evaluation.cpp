@@ -0,0 +1,31 @@
+#include "Evaluation.hpp"
+#include "CardTable.hpp"
+
+int Evaluation::pokemonScore(int player, int slot, const ActivePokemon& pokemon) {
+    if (pokemon.isEmpty()) {
+        return 0;
+    }
+
+    // Damage on the active Pokemon counts against its player, benched Pokemon count for it
+    if (slot == ACTIVE_SLOT) {
+        return -sign(player) * (CardTable::getStats(pokemon.card).hp - pokemon.currentHP) * DAMAGE_WEIGHT;
+    }
+    return sign(player) * BENCH_WEIGHT;
+}
+
+int Evaluation::computeScore(const GameState& state) {
+    int score = 0;
+    for (int player = 0; player < 2; player++) {
+        score += pointsScore(player, state.playerPoints[player]);
+        score += pokemonScore(player, ACTIVE_SLOT, state.playerActiveSpots[player]);
+        for (int b = 0; b < state.playerBenchSize[player]; b++) {
+            score += pokemonScore(player, b + 1, state.playerBenchSpots[player][b]);
+        }
+    }
+    return score;
+}
+
+int Evaluation::bound() {
+    // All points and a full bench against none, and the most damage an active Pokemon can hold
+    return 3 * POINT_WEIGHT + MAX_BENCH_SIZE * BENCH_WEIGHT + CardTable::getMaxHP() * DAMAGE_WEIGHT;
+}
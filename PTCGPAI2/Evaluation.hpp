@@ -0,0 +1,35 @@
+#ifndef EVALUATION_HPP
+#define EVALUATION_HPP
+
+#include "GameState.hpp"
+
+using namespace std;
+
+// Static evaluation of a position as a sum of features, each scored for player 0. Game keeps the sum in
+// GameState::evaluation up to date: whenever a feature changes it subtracts the old score and adds the new one.
+// Everything about a Pokemon spot is scored by pokemonScore, and Game rescores a spot whenever anything on it
+// changes, so new per-Pokemon features (energy attached, turns to a knockout) only need to be added there
+class Evaluation {
+public:
+    static constexpr int POINT_WEIGHT = 100;  // Per point
+    static constexpr int BENCH_WEIGHT = 10;   // Per benched Pokemon, more options later
+    static constexpr int DAMAGE_WEIGHT = 1;   // Per damage on an active Pokemon
+
+    // Score of a Pokemon spot for player 0. Empty spots score 0
+    static int pokemonScore(int player, int slot, const ActivePokemon& pokemon);
+    static int pointsScore(int player, int points) { return sign(player) * points * POINT_WEIGHT; }
+
+    // Score of a position for the given player, a single load
+    static int scoreFor(const GameState& state, int player) { return player == 0 ? state.evaluation : -state.evaluation; }
+
+    // Recomputes the score of a position from scratch
+    static int computeScore(const GameState& state);
+
+    // No position scores outside [-bound(), bound()] for either player
+    static int bound();
+
+private:
+    static int sign(int player) { return player == 0 ? 1 : -1; }
+};
+
+#endif // EVALUATION_HPP
@@ -2,299 +2,301 @@
 #include "deck.hpp"
 #include "Action.hpp"
 #include "GameState.hpp"
+#include "Zobrist.hpp"
+#include "Evaluation.hpp"
 
-#include <random>
 #include <iostream>
 #include <algorithm>
 
 using namespace std;
 
-// Constructor for ActivePokemon, initializes currentHP from the pokemonCard's HP
-ActivePokemon::ActivePokemon(std::shared_ptr<Card> card)
-    : pokemonCard(card), currentHP(card->hp), currentEnergy() {  // Assuming Card has an `hp` member
+// Creates the in-play representation of a card, initializes currentHP from the card's HP
+static ActivePokemon makeActivePokemon(CardID card) {
+    ActivePokemon pokemon;
+    pokemon.card = card;
+    pokemon.currentHP = CardTable::getStats(card).hp;
+    return pokemon;
 }
 
-ActivePokemon::ActivePokemon(const ActivePokemon& other)
-    : pokemonCard(other.pokemonCard),  // Shared ownership of the Card
-    currentHP(other.currentHP),
-    currentEnergy(other.currentEnergy) {
-    // No need for deep copy of pokemonCard since it's a shared_ptr
+// Number of copies of a card in a player's hand
+static int countInHand(const GameState& state, int player, CardID card) {
+    return (int)count(state.playerHands[player], state.playerHands[player] + state.playerHandSize[player], card);
 }
 
-// Method to add energy to the Pokemon's energy pool
-void ActivePokemon::addEnergy(char energyType) {
-    currentEnergy.push_back(energyType);
-}
-
-// Method to remove energy from the Pokemon's energy pool
-void ActivePokemon::removeEnergy(char energyType) {
-    auto it = std::find(currentEnergy.begin(), currentEnergy.end(), energyType);
-    if (it != currentEnergy.end()) {
-        currentEnergy.erase(it);
-    }
-}
-
-// Display the active Pokemon's information
-void ActivePokemon::displayActivePokemon() const {
-    std::cout << "Active Pokemon: " << pokemonCard->name << std::endl;
-    std::cout << "HP: " << currentHP << std::endl;
-    std::cout << "Energy: ";
-    for (char energy : currentEnergy) {
-        std::cout << energy << " ";
-    }
-    std::cout << std::endl;
-}
-
-Game::Game(shared_ptr<Deck> player1Deck, shared_ptr<Deck> player2Deck, bool silent)
-    : silent(silent) {
-    // Create shallow copies of the player decks for use in the game state
-    playerDecks[0] = player1Deck;
-    playerDecks[1] = player2Deck;
+template <typename LogPolicy>
+BasicGame<LogPolicy>::BasicGame(shared_ptr<Deck> player1Deck, shared_ptr<Deck> player2Deck, const Rng& rng) {
+    state.rng = rng;
+    deckOwners[0] = player1Deck;
+    deckOwners[1] = player2Deck;
 
-    // Initialize GameState with shallow copies of the decks
     for (int i = 0; i < 2; i++) {
-        for (const auto& card : playerDecks[i]->cards) {
-            gameDecks[i].push_back(card);  // Copy each card into the game's deck
+        // Initialize the game deck with the ID of every card in the deck
+        const auto& cards = deckOwners[i]->cards;
+        state.gameDeckSize[i] = (uint8_t)min<size_t>(cards.size(), MAX_GAME_DECK_SIZE);
+        for (int c = 0; c < state.gameDeckSize[i]; c++) {
+            state.gameDecks[i][c] = (CardID)cards[c]->cardID;
+        }
+
+        // Copy the energy types the deck generates
+        vector<char> energyTypes = deckOwners[i]->getEnergyTypes();
+        state.playerEnergyTypeCount[i] = (uint8_t)min<size_t>(energyTypes.size(), MAX_DECK_ENERGY_TYPES);
+        for (int e = 0; e < state.playerEnergyTypeCount[i]; e++) {
+            state.playerEnergyTypes[i][e] = energyTypes[e];
         }
-    }
 
-    for (int i = 0; i < 2; i++) {
         // Initialize points for both players
-        playerPoints[i] = 0;
+        state.playerPoints[i] = 0;
         // Set energy availible to X (placeholder value) for safety
-        playerAvailableEnergy[i] = 'X';
+        state.playerAvailableEnergy[i] = 'X';
     }
 
     // Randomly select who goes first
-    random_device rd;
-    default_random_engine rng(rd());
-    currentPlayer = uniform_int_distribution<int>(0, 1)(rng);  // Randomly pick 0 or 1 for first player
+    state.currentPlayer = (int8_t)state.rng.below(2);  // Randomly pick 0 or 1 for first player
 
-    cout << "Player " << currentPlayer + 1 << " will go first!" << endl;
+    if constexpr (LogPolicy::enabled)
+        log.record({ .type = GameEventType::FIRST_PLAYER, .player = state.currentPlayer });
+    state.zobristKey = Zobrist::computeKey(state);
+    state.evaluation = Evaluation::computeScore(state);
 
     // Draw 5 cards for each player
     drawInitialCards(0);  // Draw 5 cards for Player 1
     drawInitialCards(1);  // Draw 5 cards for Player 2
-
-    damageDealt->push_back(0);
-    damageDealt->push_back(0);
-}
-
-Game::Game(const std::shared_ptr<GameState>& state, bool silent) 
-    : silent(silent) {
-    // Restore player points
-    playerPoints[0] = state->playerPoints[0];
-    playerPoints[1] = state->playerPoints[1];
-
-    // Restore hands
-    playerHands[0] = state->playerHands[0];
-    playerHands[1] = state->playerHands[1];
-
-    // Restore active Pokmon (deep copy)
-    playerActiveSpots[0] = state->playerActiveSpots[0] ?
-        std::make_shared<ActivePokemon>(*state->playerActiveSpots[0]) : nullptr;
-    playerActiveSpots[1] = state->playerActiveSpots[1] ?
-        std::make_shared<ActivePokemon>(*state->playerActiveSpots[1]) : nullptr;
-
-    // Restore bench Pokmon (deep copy)
-    for (const auto& pokemon : state->playerBenchSpots[0]) {
-        playerBenchSpots[0].push_back(std::make_shared<ActivePokemon>(*pokemon));
-    }
-    for (const auto& pokemon : state->playerBenchSpots[1]) {
-        playerBenchSpots[1].push_back(std::make_shared<ActivePokemon>(*pokemon));
-    }
-
-    // Restore available energy
-    playerAvailableEnergy[0] = state->playerAvailableEnergy[0];
-    playerAvailableEnergy[1] = state->playerAvailableEnergy[1];
-
-    // Restore decks
-    playerDecks[0] = make_shared<Deck>();
-    playerDecks[1] = make_shared<Deck>();
-    playerDecks[0]->cards = state->playerDecks[0];
-    playerDecks[1]->cards = state->playerDecks[1];
-
-    gameDecks[0] = state->gameDecks[0];
-    gameDecks[1] = state->gameDecks[1];
-
-    // Restore game state
-    gameOver = state->gameOver;
-    currentPlayer = state->currentPlayer;
-    winner = state->winner;
-    damageDealt->push_back(state->damageDealt[0]);
-    damageDealt->push_back(state->damageDealt[1]);
 }
 
-// Getter for playerActiveSpots
-const std::shared_ptr<ActivePokemon>& Game::getPlayerActiveSpot(int player) const {
-    return playerActiveSpots[player];
-}
-
-// Getter for playerBenchSpots
-const std::vector<std::shared_ptr<ActivePokemon>>& Game::getPlayerBenchSpots(int player) const {
-    return playerBenchSpots[player];
+// Restoring from a snapshot is a plain copy of the flat state
+template <typename LogPolicy>
+BasicGame<LogPolicy>::BasicGame(const GameState& state, bool drawEnergy)
+    : state(state) {
+    // Restored games are used for look-ahead and, as before, do not draw energy for future turns.
+    // Playouts to the end of the game need it, so they keep it
+    if (!drawEnergy) {
+        this->state.playerEnergyTypeCount[0] = 0;
+        this->state.playerEnergyTypeCount[1] = 0;
+    }
 }
 
-// Set silent mode
-void Game::setSilent(bool silent) {
-    this->silent = silent;
+template <typename LogPolicy>
+const GameState& BasicGame<LogPolicy>::getGameState() const {
+    return state;
 }
 
-std::shared_ptr<GameState> Game::getGameState() {
-    auto state = make_shared<GameState>();
-
-    // Set player points
-    state->playerPoints[0] = playerPoints[0];
-    state->playerPoints[1] = playerPoints[1];
-
-    // Set hand sizes
-    state->playerHandSize[0] = playerHands[0].size();
-    state->playerHandSize[1] = playerHands[1].size();
-
-    // Set active Pokmon (deep copy)
-    state->playerActiveSpots[0] = playerActiveSpots[0] ?
-        std::make_shared<ActivePokemon>(*playerActiveSpots[0]) : nullptr;
-    state->playerActiveSpots[1] = playerActiveSpots[1] ?
-        std::make_shared<ActivePokemon>(*playerActiveSpots[1]) : nullptr;
+template <typename LogPolicy>
+void BasicGame<LogPolicy>::makeAction(const Action& action, UndoRecord& undo) {
+    const int player = state.currentPlayer;
+
+    undo.type = action.type;
+    undo.currentPlayer = state.currentPlayer;
+    undo.gameOver = state.gameOver;
+    undo.winner = state.winner;
+    undo.zobristKey = state.zobristKey;
+    undo.evaluation = state.evaluation;
+    undo.canonicalPlayFrom = state.canonicalPlayFrom;
+    undo.rng = state.rng;
+    for (int i = 0; i < 2; i++) {
+        undo.playerPoints[i] = state.playerPoints[i];
+        undo.playerAvailableEnergy[i] = state.playerAvailableEnergy[i];
+        undo.damageDealt[i] = state.damageDealt[i];
+    }
 
-    // Set bench Pokmon (deep copy)
-    for (const auto& pokemon : playerBenchSpots[0]) {
-        state->playerBenchSpots[0].push_back(std::make_shared<ActivePokemon>(*pokemon));
+    switch (action.type) {
+    case ActionType::PLAY:
+        undo.index = action.target;
+        if (action.target < state.playerHandSize[player]) {
+            undo.card = state.playerHands[player][action.target];
+            undo.playedToSlot = state.playerActiveSpots[player].isEmpty() ? ACTIVE_SLOT : state.playerBenchSize[player] + 1;
+        }
+        undo.applied = playPokemon(player, action.target);
+        break;
+    case ActionType::ENERGY:
+        undo.index = action.target;
+        undo.applied = attachEnergy(action.target);
+        break;
+    case ActionType::BENCH:
+        undo.index = action.target;
+        undo.savedPokemon = state.playerActiveSpots[player];
+        undo.applied = action.target >= 1 && action.target <= state.playerBenchSize[player];
+        playPokemonFromBench(player, action.target);
+        break;
+    case ActionType::ATTACK: {
+        const int opponent = 1 - player;
+        const uint8_t benchBefore = state.playerBenchSize[opponent];
+        undo.savedPokemon = state.playerActiveSpots[opponent];
+        performAttack(action.attack);
+        undo.promoted = state.playerBenchSize[opponent] < benchBefore;
+        undo.applied = true;
+        break;
     }
-    for (const auto& pokemon : playerBenchSpots[1]) {
-        state->playerBenchSpots[1].push_back(std::make_shared<ActivePokemon>(*pokemon));
+    case ActionType::END_TURN:
+        endTurn();
+        undo.applied = true;
+        break;
+    case ActionType::ROOT:
+        break;
     }
 
-    // Set available energy
-    state->playerAvailableEnergy[0] = playerAvailableEnergy[0];
-    state->playerAvailableEnergy[1] = playerAvailableEnergy[1];
-
-    // Set player hands
-    state->playerHands[0] = playerHands[0];
-    state->playerHands[1] = playerHands[1];
-
-    // Set decks
-    state->playerDecks[0] = playerDecks[0]->cards;
-    state->playerDecks[1] = playerDecks[1]->cards;
-    state->gameDecks[0] = gameDecks[0];
-    state->gameDecks[1] = gameDecks[1];
+    // An outcome only applies to the action it was set for, even one that did not end the turn
+    energyOutcome = -1;
+}
 
-    // Set game-over status
-    state->gameOver = gameOver;
+template <typename LogPolicy>
+void BasicGame<LogPolicy>::setEnergyOutcome(int outcome) {
+    energyOutcome = (int8_t)outcome;
+}
 
-    // Set current player
-    state->currentPlayer = currentPlayer;
+template <typename LogPolicy>
+void BasicGame<LogPolicy>::unmakeAction(const UndoRecord& undo) {
+    const int player = undo.currentPlayer;
 
-    // Set winner
-    state->winner = winner;
+    if (undo.applied) {
+        switch (undo.type) {
+        case ActionType::PLAY: {
+            // Take the Pokemon back off the board
+            if (undo.playedToSlot == ACTIVE_SLOT) {
+                state.playerActiveSpots[player] = ActivePokemon();
+            }
+            else {
+                state.playerBenchSpots[player][--state.playerBenchSize[player]] = ActivePokemon();
+            }
 
-    // Save damageDealt
-    state->damageDealt[0] = damageDealt[0].empty() ? 0 : damageDealt[0][0];
-    state->damageDealt[1] = damageDealt[1].empty() ? 0 : damageDealt[1][0];
+            // Put the card back where it was in the hand
+            CardID* hand = state.playerHands[player];
+            for (int i = state.playerHandSize[player]; i > undo.index; i--) {
+                hand[i] = hand[i - 1];
+            }
+            hand[undo.index] = undo.card;
+            state.playerHandSize[player]++;
+            break;
+        }
+        case ActionType::ENERGY: {
+            state.slot(player, undo.index).removeEnergy(undo.playerAvailableEnergy[player]);
+            break;
+        }
+        case ActionType::BENCH: {
+            // Shift the bench back and return the promoted Pokemon to its spot
+            int benchIndex = undo.index - 1;
+            for (int b = state.playerBenchSize[player]; b > benchIndex; b--) {
+                state.playerBenchSpots[player][b] = state.playerBenchSpots[player][b - 1];
+            }
+            state.playerBenchSpots[player][benchIndex] = state.playerActiveSpots[player];
+            state.playerBenchSize[player]++;
+            state.playerActiveSpots[player] = undo.savedPokemon;
+            break;
+        }
+        case ActionType::ATTACK: {
+            const int opponent = 1 - player;
+            if (undo.promoted) {
+                for (int b = state.playerBenchSize[opponent]; b > 0; b--) {
+                    state.playerBenchSpots[opponent][b] = state.playerBenchSpots[opponent][b - 1];
+                }
+                state.playerBenchSpots[opponent][0] = state.playerActiveSpots[opponent];
+                state.playerBenchSize[opponent]++;
+            }
+            state.playerActiveSpots[opponent] = undo.savedPokemon;
+            break;
+        }
+        default:
+            break;
+        }
+    }
 
-    return state;
+    state.currentPlayer = undo.currentPlayer;
+    state.gameOver = undo.gameOver;
+    state.winner = undo.winner;
+    state.zobristKey = undo.zobristKey;
+    state.evaluation = undo.evaluation;
+    state.canonicalPlayFrom = undo.canonicalPlayFrom;
+    state.rng = undo.rng;
+    for (int i = 0; i < 2; i++) {
+        state.playerPoints[i] = undo.playerPoints[i];
+        state.playerAvailableEnergy[i] = undo.playerAvailableEnergy[i];
+        state.damageDealt[i] = undo.damageDealt[i];
+    }
 }
 
 // Function to check if a player has no Pokemon left (active or bench)
-bool Game::hasNoPokemon(int player) {
-    return playerActiveSpots[player] == nullptr && playerBenchSpots[player].empty();
+template <typename LogPolicy>
+bool BasicGame<LogPolicy>::hasNoPokemon(int player) {
+    return state.playerActiveSpots[player].isEmpty() && state.playerBenchSize[player] == 0;
 }
 
 // Function to check for a winner (either 3 points or no Pokemon left for a player)
-void Game::checkForWinner() {
-    if (playerPoints[0] >= 3) {
-        if(!silent)
-            cout << "Player 1 wins with 3 points!" << endl;
-        winner = 0;  // Set winner to Player 1
-        gameOver = true;
-    }
-    else if (playerPoints[1] >= 3) {
-        if (!silent)
-            cout << "Player 2 wins with 3 points!" << endl;
-        winner = 1;  // Set winner to Player 2
-        gameOver = true;
+template <typename LogPolicy>
+void BasicGame<LogPolicy>::checkForWinner() {
+    if (state.playerPoints[0] >= 3) {
+        if constexpr (LogPolicy::enabled)
+            log.record({ .type = GameEventType::WIN_BY_POINTS, .player = 0 });
+        declareWinner(0);  // Set winner to Player 1
+    }
+    else if (state.playerPoints[1] >= 3) {
+        if constexpr (LogPolicy::enabled)
+            log.record({ .type = GameEventType::WIN_BY_POINTS, .player = 1 });
+        declareWinner(1);  // Set winner to Player 2
     }
     else if (hasNoPokemon(0)) {
-        if (!silent)
-            cout << "Player 1 has no Pokemon left. Player 2 wins!" << endl;
-        winner = 1;  // Set winner to Player 2
-        gameOver = true;
+        if constexpr (LogPolicy::enabled)
+            log.record({ .type = GameEventType::NO_POKEMON_LEFT, .player = 0 });
+        declareWinner(1);  // Set winner to Player 2
     }
     else if (hasNoPokemon(1)) {
-        if (!silent)
-            cout << "Player 2 has no Pokemon left. Player 1 wins!" << endl;
-        winner = 0;  // Set winner to Player 1
-        gameOver = true;
+        if constexpr (LogPolicy::enabled)
+            log.record({ .type = GameEventType::NO_POKEMON_LEFT, .player = 1 });
+        declareWinner(0);  // Set winner to Player 1
     }
 }
 
-bool Game::isWinner() {
-    return gameOver;
+// Ends the game in favour of a player and updates the position key
+template <typename LogPolicy>
+void BasicGame<LogPolicy>::declareWinner(int player) {
+    state.zobristKey ^= Zobrist::outcomeKey(state.gameOver, state.winner) ^ Zobrist::outcomeKey(true, player);
+    state.winner = player;
+    state.gameOver = true;
 }
 
-vector<Action> Game::getValidActions() {
-    vector<Action> validActions;
+template <typename LogPolicy>
+bool BasicGame<LogPolicy>::isWinner() {
+    return state.gameOver;
+}
+
+template <typename LogPolicy>
+MoveList BasicGame<LogPolicy>::getValidActions() {
+    MoveList validActions;
+    const int player = state.currentPlayer;
+    const ActivePokemon& activePokemon = state.playerActiveSpots[player];
 
     // Check if the player can play a Pokemon card (they have cards in hand and space in active or bench)
-    if (!playerHands[currentPlayer].empty()) {
-        bool canPlayToActive = playerActiveSpots[currentPlayer] == nullptr;  // Active spot must be empty
-        bool canPlayToBench = playerBenchSpots[currentPlayer].size() < 3;  // Bench must have fewer than 3 Pokemon
+    if (state.playerHandSize[player] > 0) {
+        bool canPlayToActive = activePokemon.isEmpty();  // Active spot must be empty
+        bool canPlayToBench = state.playerBenchSize[player] < MAX_BENCH_SIZE;  // Bench must have fewer than 3 Pokemon
 
         if (canPlayToActive || canPlayToBench) {
-            for (size_t i = 0; i < playerHands[currentPlayer].size(); ++i) {
-                validActions.push_back(Action(ActionType::PLAY, playerHands[currentPlayer].at(i)));
+            for (int i = 0; i < state.playerHandSize[player]; ++i) {
+                validActions.push_back(Action(ActionType::PLAY, i));
             }
         }
     }
 
     //Attaching energy actions
-    if (playerAvailableEnergy[currentPlayer] != 'X') {
-        for (auto& pokemon : playerBenchSpots[currentPlayer]) {
-            validActions.push_back(Action(ActionType::ENERGY, pokemon));
+    const char availableEnergy = state.playerAvailableEnergy[player];
+    if (availableEnergy != 'X') {
+        for (int b = 0; b < state.playerBenchSize[player]; b++) {
+            if (state.playerBenchSpots[player][b].canAddEnergy(availableEnergy)) {
+                validActions.push_back(Action(ActionType::ENERGY, b + 1));
+            }
         }
-        if (playerActiveSpots[currentPlayer] != nullptr) {
-            validActions.push_back(Action(ActionType::ENERGY, playerActiveSpots[currentPlayer]));
+        if (!activePokemon.isEmpty() && activePokemon.canAddEnergy(availableEnergy)) {
+            validActions.push_back(Action(ActionType::ENERGY, ACTIVE_SLOT));
         }
-    } 
+    }
 
     //Attacking actions
-    if (playerActiveSpots[currentPlayer]) {
-        shared_ptr<ActivePokemon> activePokemon = playerActiveSpots[currentPlayer];
-
-        // Assume the Pokemon has one main attack with a fixed energy requirement (simplified)
-        vector<EnergyRequirement> attackCost = activePokemon->pokemonCard->attacks.at(0).energyRequirement;
-
-        // Check if the active Pokemon has the required energy
-        bool hasEnoughEnergy = true;
-        vector<char> tempEnergy = activePokemon->currentEnergy; // Copy energy pool for manipulation
-
-        for (const EnergyRequirement& requirement : attackCost) {
-            if (requirement.type == 'X') {
-                // X energy can be satisfied by any energy
-                if (tempEnergy.size() < requirement.amount) {
-                    hasEnoughEnergy = false;
-                    break;
-                }
-                // Remove any energies to satisfy the X cost
-                tempEnergy.erase(tempEnergy.begin(), tempEnergy.begin() + requirement.amount);
-            }
-            else {
-                // Count required type
-                int availableCount = count(tempEnergy.begin(), tempEnergy.end(), requirement.type);
-                if (availableCount < requirement.amount) {
-                    hasEnoughEnergy = false;
-                    break;
-                }
-                // Remove used energy
-                int removed = 0;
-                tempEnergy.erase(remove_if(tempEnergy.begin(), tempEnergy.end(),
-                    [&](char e) { return e == requirement.type && removed++ < requirement.amount; }),
-                    tempEnergy.end());
-            }
-        }
+    if (!activePokemon.isEmpty()) {
+        const CardStats& stats = CardTable::getStats(activePokemon.card);
 
-        if (hasEnoughEnergy) {
-            validActions.push_back(Action(ActionType::ATTACK, activePokemon->pokemonCard->attacks.at(0)));
+        // Check every attack against the attached energy, 'X' can be paid with any energy
+        for (int a = 0; a < stats.attackCount; a++) {
+            if (canAfford(activePokemon.currentEnergy, stats.attacks[a].cost)) {
+                validActions.push_back(Action(ActionType::ATTACK, ACTIVE_SLOT, a));
+            }
         }
     }
 
@@ -305,298 +307,308 @@ vector<Action> Game::getValidActions() {
 }
 
 // Function to display the valid actions for a player
-void Game::displayValidActions() {
-    vector<Action> actions = getValidActions();
+template <typename LogPolicy>
+void BasicGame<LogPolicy>::displayValidActions() requires LogPolicy::enabled {
+    MoveList actions = getValidActions();
 
-    if (!silent)
-        cout << "Player " << currentPlayer + 1 << " can perform the following actions:" << endl;
+    cout << "Player " << state.currentPlayer + 1 << " can perform the following actions:" << endl;
     for (const Action& action : actions) {
-        switch (action.type) {
-        case ActionType::PLAY:
-            if (!silent)
-                cout << "Play " << action.targetCard->name << endl;
-            break;
-        case ActionType::ATTACK:
-            if (!silent)
-                cout << "Attack with " << playerActiveSpots[currentPlayer]->pokemonCard->name << " using " << action.targetAttack.name << " for " << action.targetAttack.damage << endl;
-            break;
-        case ActionType::ENERGY:
-            if (!silent)
-                cout << "Attach " << playerAvailableEnergy[currentPlayer] << " to " << action.targetPokemon->pokemonCard->name << endl;
-            break;
-        case ActionType::END_TURN:
-            if (!silent)
-                cout << "End turn" << endl;
-            break;
-
-        }
+        action.display(state);
     }
 }
 
-void Game::shuffleDeck(int player) {
-    shuffle(gameDecks[player].begin(), gameDecks[player].end(), default_random_engine(random_device()()));
-    if (!silent)
-        cout << "Player " << player + 1 << "'s deck has been shuffled.\n";
+template <typename LogPolicy>
+void BasicGame<LogPolicy>::shuffleDeck(int player) {
+    state.rng.shuffle(state.gameDecks[player], state.gameDeckSize[player]);
+    if constexpr (LogPolicy::enabled)
+        log.record({ .type = GameEventType::DECK_SHUFFLED, .player = player });
 }
 
 // Function to draw 5 cards for a player
-void Game::drawInitialCards(int player) {
+template <typename LogPolicy>
+void BasicGame<LogPolicy>::drawInitialCards(int player) {
     shuffleDeck(player);
     for (int i = 0; i < 5; ++i) {
-        shared_ptr<Card> drawnCard = drawCard(player);
-        if (drawnCard) {
-            playerHands[player].push_back(drawnCard);  // Add drawn card to player's hand
+        CardID drawnCard = drawCard(player);
+        if (drawnCard != NO_CARD && state.playerHandSize[player] < MAX_HAND_SIZE) {
+            state.zobristKey ^= Zobrist::handKey(player, drawnCard, countInHand(state, player, drawnCard));
+            state.playerHands[player][state.playerHandSize[player]++] = drawnCard;  // Add drawn card to player's hand
         }
     }
 
-    if (!silent)
-        cout << "Player " << player + 1 << " has drawn 5 cards." << endl;
+    if constexpr (LogPolicy::enabled)
+        log.record({ .type = GameEventType::CARDS_DRAWN, .player = player, .value = 5 });
 }
 
-// Draws a card from the deck and returns it
-shared_ptr<Card> Game::drawCard(int player) {
-    if (gameDecks[player].empty()) {
-        if (!silent)
-            cout << "Player " << player + 1 << "'s deck is empty.\n";
-        return nullptr;
+// Draws a card from the deck and returns its ID, or NO_CARD if the deck is empty
+template <typename LogPolicy>
+CardID BasicGame<LogPolicy>::drawCard(int player) {
+    if (state.gameDeckSize[player] == 0) {
+        if constexpr (LogPolicy::enabled)
+            log.record({ .type = GameEventType::DECK_EMPTY, .player = player });
+        return NO_CARD;
     }
-    shared_ptr<Card> cardToDraw = gameDecks[player].back();
-    gameDecks[player].pop_back();  // Remove the card from the deck
+    CardID cardToDraw = state.gameDecks[player][--state.gameDeckSize[player]];
+    state.gameDecks[player][state.gameDeckSize[player]] = 0;  // Remove the card from the deck
     return cardToDraw;
 }
 
 // Method to show each player's hand
-void Game::showHands() const {
+template <typename LogPolicy>
+void BasicGame<LogPolicy>::showHands() const requires LogPolicy::enabled {
     for (int i = 0; i < 2; ++i) {
-        if (!silent)
-            cout << "Player " << i + 1 << " hand:" << endl;
-        for (const auto& card : playerHands[i]) {
-            if (!silent)
-                cout << card->name << endl;  // Assuming Card has a name field
+        cout << "Player " << i + 1 << " hand:" << endl;
+        for (int c = 0; c < state.playerHandSize[i]; c++) {
+            cout << CardTable::getName(state.playerHands[i][c]) << endl;
         }
-        if (!silent)
-            cout << endl;
+        cout << endl;
     }
 }
 
-//overload to allow playing card by index
-bool Game::playPokemon(int player, int cardFromHand) {
-    return playPokemon(player, playerHands[player].at(cardFromHand));
-}
-
-// Function to play a Pokemon card
-bool Game::playPokemon(int player, shared_ptr<Card> card) {
+// Function to play a Pokemon card by its index in the hand
+template <typename LogPolicy>
+bool BasicGame<LogPolicy>::playPokemon(int player, int cardFromHand) {
     // Ensure the card exists in the player's hand
-    auto it = find_if(playerHands[player].begin(), playerHands[player].end(),
-        [&card](const shared_ptr<Card>& c) { return c == card; });
-
-    if (it == playerHands[player].end()) {
-        if (!silent)
-            cout << "Player " << player + 1 << " does not have the specified card in hand." << endl;
+    if (cardFromHand < 0 || cardFromHand >= state.playerHandSize[player]) {
+        if constexpr (LogPolicy::enabled)
+            log.record({ .type = GameEventType::CARD_NOT_IN_HAND, .player = player });
         return false;
     }
 
+    CardID card = state.playerHands[player][cardFromHand];
+
     // Check if there is an open spot in the player's active or bench positions
-    if (playerActiveSpots[player] == nullptr && playerBenchSpots[player].size() < 5) {
+    if (state.playerActiveSpots[player].isEmpty()) {
         // If no Pokemon is in the active spot, create an ActivePokemon and place it there
-        playerActiveSpots[player] = make_shared<ActivePokemon>(card); // Assume the original card has an `hp` field
-        if (!silent)
-            cout << "Player " << player + 1 << " played "
-            << "\033[1;32m" << card->name << "\033[0m"  // Green color for the card name
-            << " to their active spot." << endl;
+        state.playerActiveSpots[player] = makeActivePokemon(card);
+        state.zobristKey ^= Zobrist::pokemonKey(player, ACTIVE_SLOT, state.playerActiveSpots[player]);
+        state.evaluation += Evaluation::pokemonScore(player, ACTIVE_SLOT, state.playerActiveSpots[player]);
+        if constexpr (LogPolicy::enabled)
+            log.record({ .type = GameEventType::POKEMON_PLAYED, .player = player, .detail = ACTIVE_SLOT, .card = card });
     }
-    else if (playerActiveSpots[player] != nullptr && playerBenchSpots[player].size() < 5) {
+    else if (state.playerBenchSize[player] < MAX_BENCH_SIZE) {
         // If there is a Pokemon in the active spot, create an ActivePokemon and place it on the bench
-        playerBenchSpots[player].push_back(make_shared<ActivePokemon>(card));
-        if (!silent)
-            cout << "Player " << player + 1 << " played "
-            << "\033[1;32m" << card->name << "\033[0m"  // Green color for the card name
-            << " to their bench." << endl;
+        state.playerBenchSpots[player][state.playerBenchSize[player]++] = makeActivePokemon(card);
+        state.zobristKey ^= Zobrist::pokemonKey(player, state.playerBenchSize[player], state.playerBenchSpots[player][state.playerBenchSize[player] - 1]);
+        state.evaluation += Evaluation::pokemonScore(player, state.playerBenchSize[player], state.playerBenchSpots[player][state.playerBenchSize[player] - 1]);
+        if constexpr (LogPolicy::enabled)
+            log.record({ .type = GameEventType::POKEMON_PLAYED, .player = player, .detail = state.playerBenchSize[player], .card = card });
     }
     else {
         // No space to play Pokemon
-        if (!silent)
-            cout << "Player " << player + 1 << " cannot play " << card->name << " due to no available spots." << endl;
+        if constexpr (LogPolicy::enabled)
+            log.record({ .type = GameEventType::NO_SPOT, .player = player, .card = card });
         return false;
     }
 
     // Remove the card from the player's hand
-    removeCardFromHand(player, card);
+    removeCardFromHand(player, cardFromHand);
     return true;
 }
 
 // for moving pokemon from bench to active when pokemon is knocked out
-void Game::playPokemonFromBench(int player, shared_ptr<ActivePokemon> targetPokemon) {
-    // Find the target Pokmon in the bench
-    auto it = find_if(playerBenchSpots[currentPlayer].begin(), playerBenchSpots[currentPlayer].end(), [&](const shared_ptr<ActivePokemon>& pokemon) {
-        return pokemon == targetPokemon;
-        });
+template <typename LogPolicy>
+void BasicGame<LogPolicy>::playPokemonFromBench(int player, int benchSlot) {
+    int benchIndex = benchSlot - 1;
+
+    // If the target Pokemon is found in the bench
+    if (benchIndex >= 0 && benchIndex < state.playerBenchSize[player]) {
+        // Every spot from the active one to the end of the bench moves, so rehash and rescore those spots
+        state.zobristKey ^= Zobrist::pokemonKey(player, ACTIVE_SLOT, state.playerActiveSpots[player]);
+        state.evaluation -= Evaluation::pokemonScore(player, ACTIVE_SLOT, state.playerActiveSpots[player]);
+        for (int b = benchIndex; b < state.playerBenchSize[player]; b++) {
+            state.zobristKey ^= Zobrist::pokemonKey(player, b + 1, state.playerBenchSpots[player][b]);
+            state.evaluation -= Evaluation::pokemonScore(player, b + 1, state.playerBenchSpots[player][b]);
+        }
+
+        // Set the target Pokemon as the new active Pokemon
+        state.playerActiveSpots[player] = state.playerBenchSpots[player][benchIndex];
 
-    // If the target Pokmon is found in the bench
-    if (it != playerBenchSpots[currentPlayer].end()) {
-        // Remove the target Pokmon from the bench
-        playerBenchSpots[currentPlayer].erase(it);
+        // Remove the target Pokemon from the bench
+        for (int b = benchIndex + 1; b < state.playerBenchSize[player]; b++) {
+            state.playerBenchSpots[player][b - 1] = state.playerBenchSpots[player][b];
+        }
+        state.playerBenchSpots[player][--state.playerBenchSize[player]] = ActivePokemon();
 
-        // Set the target Pokmon as the new active Pokmon
-        playerActiveSpots[currentPlayer] = targetPokemon;
+        state.zobristKey ^= Zobrist::pokemonKey(player, ACTIVE_SLOT, state.playerActiveSpots[player]);
+        state.evaluation += Evaluation::pokemonScore(player, ACTIVE_SLOT, state.playerActiveSpots[player]);
+        for (int b = benchIndex; b < state.playerBenchSize[player]; b++) {
+            state.zobristKey ^= Zobrist::pokemonKey(player, b + 1, state.playerBenchSpots[player][b]);
+            state.evaluation += Evaluation::pokemonScore(player, b + 1, state.playerBenchSpots[player][b]);
+        }
     }
     else {
-        cerr << "Error: Target Pokemon not found in bench!" << endl;
+        if constexpr (LogPolicy::enabled)
+            log.record({ .type = GameEventType::BENCH_SLOT_EMPTY, .player = player, .detail = benchSlot });
     }
 }
 
-bool Game::attachEnergy(shared_ptr<ActivePokemon> targetPokemon) {
+template <typename LogPolicy>
+bool BasicGame<LogPolicy>::attachEnergy(int targetSlot) {
+    const int player = state.currentPlayer;
+
     // Check if the player has energy available
-    if (playerAvailableEnergy[currentPlayer] == 'X') {
-        if (!silent)
-            cout << "Player " << currentPlayer + 1 << " does not have energy available.\n";
+    if (state.playerAvailableEnergy[player] == 'X') {
+        if constexpr (LogPolicy::enabled)
+            log.record({ .type = GameEventType::NO_ENERGY, .player = player });
         return false;
     }
 
-    // Add energy to the chosen Pokemon
-    targetPokemon->currentEnergy.push_back(playerAvailableEnergy[currentPlayer]);
-
-    if (!silent) {
-        string energyColor;
-        switch (playerAvailableEnergy[currentPlayer]) {
-        case 'G': energyColor = "\033[32m"; break; // Green (Grass)
-        case 'F': energyColor = "\033[31m"; break; // Red (Fire)
-        case 'W': energyColor = "\033[34m"; break; // Blue (Water)
-        case 'L': energyColor = "\033[33m"; break; // Yellow (Lightning)
-        case 'P': energyColor = "\033[35m"; break; // Magenta (Psychic)
-        case 'I': energyColor = "\033[38;5;130m"; break; // Brown/Orange (Fighting)
-        case 'D': energyColor = "\033[90m"; break; // Dark Gray (Darkness)
-        case 'M': energyColor = "\033[37m"; break; // Light Gray (Metal)
-        default:  energyColor = "\033[0m"; break; // Reset
-        }
-
-        string pokemonColor = "\033[32m"; // Green for Pokmon names
-        string resetColor = "\033[0m";    // Reset color
+    ActivePokemon& targetPokemon = state.slot(player, targetSlot);
+    if (targetPokemon.isEmpty()) {
+        if constexpr (LogPolicy::enabled)
+            log.record({ .type = GameEventType::NO_TARGET, .player = player, .detail = targetSlot });
+        return false;
+    }
 
-        cout << "Player " << currentPlayer + 1 << " attached "
-            << energyColor << playerAvailableEnergy[currentPlayer] << resetColor
-            << " energy to " << pokemonColor << targetPokemon->pokemonCard->name
-            << resetColor << ".\n";
+    // Add energy to the chosen Pokemon
+    const char energy = state.playerAvailableEnergy[player];
+    const int attached = energyCount(targetPokemon.currentEnergy, energy);
+    const int scoreBefore = Evaluation::pokemonScore(player, targetSlot, targetPokemon);
+    if (!targetPokemon.addEnergy(energy)) {
+        if constexpr (LogPolicy::enabled)
+            log.record({ .type = GameEventType::ENERGY_FULL, .player = player, .card = targetPokemon.card });
+        return false;
     }
-    playerAvailableEnergy[currentPlayer] = 'X';
+    const int typeIndex = energyTypeIndex(energy);
+    state.zobristKey ^= Zobrist::energyKey(player, targetSlot, typeIndex, attached) ^ Zobrist::energyKey(player, targetSlot, typeIndex, attached + 1);
+    state.zobristKey ^= Zobrist::availableEnergyKey(player, energy);
+    state.canonicalPlayFrom = NO_CANONICAL_PLAY;
+    state.evaluation += Evaluation::pokemonScore(player, targetSlot, targetPokemon) - scoreBefore;
+
+    if constexpr (LogPolicy::enabled)
+        log.record({ .type = GameEventType::ENERGY_ATTACHED, .player = player, .card = targetPokemon.card, .energy = energy });
+    state.playerAvailableEnergy[player] = 'X';
     return true;
 }
 
-void Game::performAttack(Attack attack) {
-    shared_ptr<ActivePokemon> attacker = playerActiveSpots[currentPlayer];
-    shared_ptr<ActivePokemon> defender = playerActiveSpots[1 - currentPlayer];
+template <typename LogPolicy>
+void BasicGame<LogPolicy>::performAttack(int attackIndex) {
+    const int player = state.currentPlayer;
+    const int opponent = 1 - player;
+    ActivePokemon& attacker = state.playerActiveSpots[player];
+    ActivePokemon& defender = state.playerActiveSpots[opponent];
 
-    if (!attacker || !defender) {
-        if (!silent)
-            cout << "Attack not possible: One or both active Pokemon are missing!" << endl;
+    if (attacker.isEmpty() || defender.isEmpty()) {
+        if constexpr (LogPolicy::enabled)
+            log.record({ .type = GameEventType::ATTACK_NOT_POSSIBLE, .player = player });
         return;
     }
 
-    string attackName = attack.name;  // Use the provided attack
-    int damage = attack.damage;       // Use the damage from the provided attack
+    int damage = CardTable::getStats(attacker.card).attacks[attackIndex].damage;  // Use the damage of the chosen attack
 
-    if (!silent)
-        cout << "Player " << currentPlayer + 1 << "'s \033[32m" << attacker->pokemonCard->name << "\033[0m "
-        << "\033[31mattacks\033[0m "
-        << "\033[32m" << defender->pokemonCard->name << "\033[0m "
-        << "using \033[31m" << attackName << "\033[0m for \033[31m" << damage << "\033[0m damage!" << endl;
+    if constexpr (LogPolicy::enabled)
+        log.record({ .type = GameEventType::ATTACK, .player = player, .detail = attackIndex, .value = damage, .card = attacker.card, .target = defender.card });
 
     // Reduce defender's HP
-    defender->currentHP -= damage;
-    damageDealt->at(currentPlayer) += damage;
-    if (defender->currentHP <= 0) {
-        if (!silent)
-            cout << defender->pokemonCard->name << " is knocked out!" << endl;
-        playerPoints[currentPlayer]++;
+    state.zobristKey ^= Zobrist::hpKey(opponent, ACTIVE_SLOT, defender.currentHP);
+    state.evaluation -= Evaluation::pokemonScore(opponent, ACTIVE_SLOT, defender);
+    defender.currentHP -= damage;
+    state.zobristKey ^= Zobrist::hpKey(opponent, ACTIVE_SLOT, defender.currentHP);
+    state.evaluation += Evaluation::pokemonScore(opponent, ACTIVE_SLOT, defender);
+    state.damageDealt[player] += damage;
+    if (defender.currentHP <= 0) {
+        if constexpr (LogPolicy::enabled)
+            log.record({ .type = GameEventType::KNOCKED_OUT, .player = opponent, .card = defender.card });
+        state.zobristKey ^= Zobrist::pointsKey(player, state.playerPoints[player]);
+        state.evaluation -= Evaluation::pointsScore(player, state.playerPoints[player]);
+        state.playerPoints[player]++;
+        state.zobristKey ^= Zobrist::pointsKey(player, state.playerPoints[player]);
+        state.evaluation += Evaluation::pointsScore(player, state.playerPoints[player]);
 
         // Remove the defeated Pokemon
-        playerActiveSpots[1 - currentPlayer] = nullptr;
+        state.zobristKey ^= Zobrist::pokemonKey(opponent, ACTIVE_SLOT, defender);
+        state.evaluation -= Evaluation::pokemonScore(opponent, ACTIVE_SLOT, defender);
+        defender = ActivePokemon();
 
         // Check if the opponent has any Pokemon left
-        if (playerBenchSpots[1 - currentPlayer].empty()) {
-            if (!silent)
-                cout << "Player " << currentPlayer + 1 << " wins the game!" << endl;
-            gameOver = true;
-            winner = currentPlayer;
+        if (state.playerBenchSize[opponent] == 0) {
+            if constexpr (LogPolicy::enabled)
+                log.record({ .type = GameEventType::WIN_BY_KNOCKOUT, .player = player });
+            declareWinner(player);
         }
         else {
             // Promote a Pokemon from the bench to active
-            playerActiveSpots[1 - currentPlayer] = playerBenchSpots[1 - currentPlayer].front();
-            playerBenchSpots[1 - currentPlayer].erase(playerBenchSpots[1 - currentPlayer].begin());
-            if(!silent)
-                cout << playerActiveSpots[1 - currentPlayer]->pokemonCard->name << " moves to the active spot!" << endl;
+            playPokemonFromBench(opponent, 1);
+            if constexpr (LogPolicy::enabled)
+                log.record({ .type = GameEventType::PROMOTED, .player = opponent, .detail = ACTIVE_SLOT, .card = defender.card });
         }
         checkForWinner();
     }
     endTurn(); // attacks always end the turn
 }
 
-// Method to remove the card from the player's hand
-void Game::removeCardFromHand(int player, shared_ptr<Card> cardToRemove) {
-    auto& hand = playerHands[player];
-    auto it = find(hand.begin(), hand.end(), cardToRemove);
-    if (it != hand.end()) {
-        hand.erase(it);
+// Method to remove the card from the player's hand, keeping the order of the remaining cards
+template <typename LogPolicy>
+void BasicGame<LogPolicy>::removeCardFromHand(int player, int cardFromHand) {
+    CardID* hand = state.playerHands[player];
+    if (cardFromHand < 0 || cardFromHand >= state.playerHandSize[player]) {
+        return;
+    }
+    state.zobristKey ^= Zobrist::handKey(player, hand[cardFromHand], countInHand(state, player, hand[cardFromHand]) - 1);
+    for (int i = cardFromHand + 1; i < state.playerHandSize[player]; i++) {
+        hand[i - 1] = hand[i];
     }
+    hand[--state.playerHandSize[player]] = 0;  // Unused entries stay zeroed so undo restores them exactly
 }
 
 // Function to display the board with the specific ASCII art pattern
-void Game::displayBoard() const {
+template <typename LogPolicy>
+void BasicGame<LogPolicy>::displayBoard() const requires LogPolicy::enabled {
+    auto name = [this](int player, int slot) -> string {
+        if (slot != ACTIVE_SLOT && slot > state.playerBenchSize[player]) {
+            return "Empty";
+        }
+        const ActivePokemon& pokemon = state.slot(player, slot);
+        return pokemon.isEmpty() ? "Empty" : CardTable::getName(pokemon.card);
+    };
+
     // Display Player 2's Bench (top row)
-    cout << (playerBenchSpots[1].size() > 0 ? playerBenchSpots[1][0]->pokemonCard->name : "Empty") << "  "
-        << (playerBenchSpots[1].size() > 1 ? playerBenchSpots[1][1]->pokemonCard->name : "Empty") << "  "
-        << (playerBenchSpots[1].size() > 2 ? playerBenchSpots[1][2]->pokemonCard->name : "Empty") << endl;
+    cout << name(1, 1) << "  " << name(1, 2) << "  " << name(1, 3) << endl;
 
     // Display Player 2's Active (middle row)
-    cout << "        " << (playerActiveSpots[1] != nullptr ? playerActiveSpots[1]->pokemonCard->name : "Empty") << endl;
+    cout << "        " << name(1, ACTIVE_SLOT) << endl;
 
     // Display Player 1's Active (middle row)
-    cout << "        " << (playerActiveSpots[0] != nullptr ? playerActiveSpots[0]->pokemonCard->name : "Empty") << endl;
+    cout << "        " << name(0, ACTIVE_SLOT) << endl;
 
     // Display Player 1's Bench (bottom row)
-    cout << (playerBenchSpots[0].size() > 0 ? playerBenchSpots[0][0]->pokemonCard->name : "Empty") << "  "
-        << (playerBenchSpots[0].size() > 1 ? playerBenchSpots[0][1]->pokemonCard->name : "Empty") << "  "
-        << (playerBenchSpots[0].size() > 2 ? playerBenchSpots[0][2]->pokemonCard->name : "Empty") << endl;
-    }
+    cout << name(0, 1) << "  " << name(0, 2) << "  " << name(0, 3) << endl;
+}
 
 // Method to start a new turn for the player
-void Game::endTurn() {
-    if (!silent)
-        cout << "Player " << currentPlayer + 1 << "'s \033[35mturn\033[0m has \033[35mended\033[0m." << endl;
-    playerAvailableEnergy[currentPlayer] = 'X';  // Clear the available energy
+template <typename LogPolicy>
+void BasicGame<LogPolicy>::endTurn() {
+    if constexpr (LogPolicy::enabled)
+        log.record({ .type = GameEventType::TURN_ENDED, .player = state.currentPlayer });
+    state.zobristKey ^= Zobrist::availableEnergyKey(state.currentPlayer, state.playerAvailableEnergy[state.currentPlayer]);
+    state.playerAvailableEnergy[state.currentPlayer] = 'X';  // Clear the available energy
+    state.canonicalPlayFrom = 0;
     // Change turn to the next player
-    currentPlayer = (currentPlayer + 1) % 2;
+    state.zobristKey ^= Zobrist::sideToMoveKey(state.currentPlayer);
+    state.currentPlayer = (state.currentPlayer + 1) % 2;
+    state.zobristKey ^= Zobrist::sideToMoveKey(state.currentPlayer);
 
     // Add energy randomly from selected energy types for the current player
-    addEnergyToPlayer(currentPlayer);
+    addEnergyToPlayer(state.currentPlayer);
 }
 
 
 // Function to add energy to the current player
-void Game::addEnergyToPlayer(int player) {
-    // Get the set of energy types selected in the player's deck
-    const auto& energyTypes = playerDecks[player]->getEnergyTypes();
-
+template <typename LogPolicy>
+void BasicGame<LogPolicy>::addEnergyToPlayer(int player) {
     // Randomly select an energy type from the player's deck energy types
-    if (!energyTypes.empty()) {
-        char selectedEnergy = energyTypes[rand() % energyTypes.size()];  // Choose a random energy type
-        playerAvailableEnergy[player] = selectedEnergy;  // Add the selected energy to the player's available energy
-        if (!silent) {
-            string colorCode;
-            switch (selectedEnergy) {
-            case 'G': colorCode = "\033[32m"; break; // Green (Grass)
-            case 'F': colorCode = "\033[31m"; break; // Red (Fire)
-            case 'W': colorCode = "\033[34m"; break; // Blue (Water)
-            case 'L': colorCode = "\033[33m"; break; // Yellow (Lightning)
-            case 'P': colorCode = "\033[35m"; break; // Magenta (Psychic)
-            case 'I': colorCode = "\033[38;5;130m"; break; // Brown/Orange (Fighting)
-            case 'D': colorCode = "\033[90m"; break; // Dark Gray (Darkness)
-            case 'M': colorCode = "\033[37m"; break; // Light Gray (Metal)
-            default:  colorCode = "\033[0m"; break; // Reset
-            }
-
-            cout << colorCode << selectedEnergy << "\033[0m has been added to Player "
-                << currentPlayer + 1 << endl;
-        }
+    if (state.playerEnergyTypeCount[player] > 0) {
+        // Choose a random energy type, unless a search fixed the outcome
+        const int outcome = energyOutcome >= 0 ? energyOutcome : (int)state.rng.below(state.playerEnergyTypeCount[player]);
+        energyOutcome = -1;
+        char selectedEnergy = state.playerEnergyTypes[player][outcome];
+        state.zobristKey ^= Zobrist::availableEnergyKey(player, state.playerAvailableEnergy[player]) ^ Zobrist::availableEnergyKey(player, selectedEnergy);
+        state.playerAvailableEnergy[player] = selectedEnergy;  // Add the selected energy to the player's available energy
+        if constexpr (LogPolicy::enabled)
+            log.record({ .type = GameEventType::ENERGY_GENERATED, .player = player, .energy = selectedEnergy });
     }
-}
\ No newline at end of file
+}
+
+template class BasicGame<SilentPolicy>;
+template class BasicGame<VerbosePolicy>;
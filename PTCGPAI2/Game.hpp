@@ -2,80 +2,105 @@
 #define GAME_HPP
 
 #include <vector>
-#include <memory>   
+#include <memory>
 
+#include "GameState.hpp"
+#include "Action.hpp"
+#include "GameLog.hpp"
 
 // Forward declaration to avoid circular dependency
-class Card;
-struct Action;
 class Deck;
-struct GameState;
-struct Attack;
 
-class ActivePokemon {
-public:
-    std::shared_ptr<Card> pokemonCard;
-    int currentHP;
-    std::vector<char> currentEnergy;
-
-    ActivePokemon(std::shared_ptr<Card> card);
-    // Copy constructor
-    ActivePokemon(const ActivePokemon& other);
+// Everything makeAction changes, so unmakeAction can restore it without copying the whole state
+struct UndoRecord {
+    ActionType type;
+    bool applied = false;       // False if the action was rejected and changed nothing
 
-    void addEnergy(char energyType);
-    void removeEnergy(char energyType);
-    void displayActivePokemon() const;
+    // Scalars that any action may touch
+    int8_t currentPlayer;
+    int8_t playerPoints[2];
+    char playerAvailableEnergy[2];
+    bool gameOver;
+    int8_t winner;
+    int16_t damageDealt[2];
+    uint64_t zobristKey;
+    int32_t evaluation;
+    uint8_t canonicalPlayFrom;
+    Rng rng;                    // Advanced when the end of a turn draws energy
+
+    int8_t index = -1;          // Hand index for PLAY, slot number for ENERGY and BENCH
+    int8_t playedToSlot = -1;   // Slot a played card ended up in
+    CardID card = NO_CARD;      // Card that left the hand
+    bool promoted = false;      // An attack knocked out the defender and promoted the bench
+    ActivePokemon savedPokemon; // Defender before an attack, or active spot before a promotion
 };
 
-class Game {
+// The game engine, parameterized on how it reports what happens. Searches play millions of moves and use
+// SilentPolicy, so their games contain no logging code at all. The interactive game uses VerbosePolicy,
+// which records structured events (see GameLog.hpp) for the game loop to print
+template <typename LogPolicy>
+class BasicGame {
 public:
-    Game(std::shared_ptr<Deck> player1Deck, std::shared_ptr<Deck> player2Deck, bool silent = false);
-    Game(const std::shared_ptr<GameState>& state, bool silent = false);
+    // All randomness of the game comes from rng, so the same decks and generator replay the same game
+    BasicGame(std::shared_ptr<Deck> player1Deck, std::shared_ptr<Deck> player2Deck, const Rng& rng = Rng::fromRandomDevice());
+    // Look-ahead games do not generate energy for future turns unless drawEnergy is set
+    BasicGame(const GameState& state, bool drawEnergy = false);
+
+    const GameState& getGameState() const;
+    LogPolicy& getLog() { return log; }
+
+    // Apply an action in place, recording what is needed to take it back
+    void makeAction(const Action& action, UndoRecord& undo);
+    // Fix which of the next player's energy types the next makeAction generates if it ends the turn,
+    // so a search can go through every outcome instead of drawing one. Index into playerEnergyTypes
+    void setEnergyOutcome(int outcome);
+    // Restore the state from before the matching makeAction, records must be undone in reverse order
+    void unmakeAction(const UndoRecord& undo);
 
-    const std::shared_ptr<ActivePokemon>& getPlayerActiveSpot(int player) const;
-    const std::vector<std::shared_ptr<ActivePokemon>>& getPlayerBenchSpots(int player) const;
-
-    void setSilent(bool silent);
-
-    std::shared_ptr<GameState> getGameState();
     bool hasNoPokemon(int player);
     void checkForWinner();
     bool isWinner();
-    std::vector<Action> getValidActions();
-    void displayValidActions();
+    MoveList getValidActions();
+    void displayValidActions() requires LogPolicy::enabled;
     void shuffleDeck(int player);
     void drawInitialCards(int player);
-    std::shared_ptr<Card> drawCard(int player);
-    void showHands() const;
+    CardID drawCard(int player);
+    void showHands() const requires LogPolicy::enabled;
     bool playPokemon(int player, int cardFromHand);
-    bool playPokemon(int player, std::shared_ptr<Card> card);
-    void playPokemonFromBench(int player, std::shared_ptr<ActivePokemon> targetPokemon);
-    bool attachEnergy(std::shared_ptr<ActivePokemon> targetPokemon);
-    void performAttack(Attack attack);
-    void removeCardFromHand(int player, std::shared_ptr<Card> cardToRemove);    
-    void displayBoard() const;
+    void playPokemonFromBench(int player, int benchIndex);
+    bool attachEnergy(int targetSlot);
+    void performAttack(int attackIndex);
+    void removeCardFromHand(int player, int cardFromHand);
+    void displayBoard() const requires LogPolicy::enabled;
     void endTurn();
 
 private:
-    std::shared_ptr<Deck> playerDecks[2];
-    std::vector<std::shared_ptr<Card>> gameDecks[2];
+    // Keeps the decks referenced by the state alive for games created from decks
+    std::shared_ptr<Deck> deckOwners[2];
 
-    std::vector<std::shared_ptr<Card>> playerHands[2];
-    std::shared_ptr<ActivePokemon> playerActiveSpots[2];
-    std::vector<std::shared_ptr<ActivePokemon>> playerBenchSpots[2];
+    GameState state;
 
-    int playerPoints[2];
-    char playerAvailableEnergy[2];
+    LogPolicy log;
+    int8_t energyOutcome = -1;  // Energy type the next endTurn generates, -1 draws one at random
 
-    bool gameOver = false;
-    int currentPlayer = 0;
-    int winner = -1;
+    void addEnergyToPlayer(int player);
+    void declareWinner(int player);
+};
 
-    std::vector<int> damageDealt[2];  // Total damage dealt by each player
+// Both instantiations are compiled once, in Game.cpp
+extern template class BasicGame<SilentPolicy>;
+extern template class BasicGame<VerbosePolicy>;
 
-    bool silent;
+// Games of the search and of self-play. Classes rather than aliases, so headers can forward declare them
+class Game : public BasicGame<SilentPolicy> {
+public:
+    using BasicGame::BasicGame;
+};
 
-    void addEnergyToPlayer(int player);
+// The interactive game, read its events with printEvents(game.getLog())
+class VerboseGame : public BasicGame<VerbosePolicy> {
+public:
+    using BasicGame::BasicGame;
 };
 
-#endif // GAME_HPP
\ No newline at end of file
+#endif // GAME_HPP
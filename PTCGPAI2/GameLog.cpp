@@ -0,0 +1,135 @@
+#include "GameLog.hpp"
+#include "CardTable.hpp"
+
+#include <iostream>
+
+using namespace std;
+
+void VerbosePolicy::record(const GameEvent& event) {
+    events[written % CAPACITY] = event;
+    written++;
+    // The slot just written held the oldest unread event, which is lost
+    if (written - read > CAPACITY) {
+        read = written - CAPACITY;
+        lost++;
+    }
+}
+
+bool VerbosePolicy::pop(GameEvent& event) {
+    if (read == written) {
+        return false;
+    }
+    event = events[read % CAPACITY];
+    read++;
+    return true;
+}
+
+size_t VerbosePolicy::size() const {
+    return (size_t)(written - read);
+}
+
+uint64_t VerbosePolicy::dropped() const {
+    return lost;
+}
+
+// ANSI color of an energy type
+static const char* energyColor(char energy) {
+    switch (energy) {
+    case 'G': return "\033[32m"; // Green (Grass)
+    case 'F': return "\033[31m"; // Red (Fire)
+    case 'W': return "\033[34m"; // Blue (Water)
+    case 'L': return "\033[33m"; // Yellow (Lightning)
+    case 'P': return "\033[35m"; // Magenta (Psychic)
+    case 'I': return "\033[38;5;130m"; // Brown/Orange (Fighting)
+    case 'D': return "\033[90m"; // Dark Gray (Darkness)
+    case 'M': return "\033[37m"; // Light Gray (Metal)
+    default:  return "\033[0m"; // Reset
+    }
+}
+
+void printEvent(const GameEvent& event) {
+    const string pokemonColor = "\033[32m"; // Green for Pokemon names
+    const string resetColor = "\033[0m";    // Reset color
+    const int player = event.player + 1;
+
+    switch (event.type) {
+    case GameEventType::FIRST_PLAYER:
+        cout << "Player " << player << " will go first!" << endl;
+        break;
+    case GameEventType::DECK_SHUFFLED:
+        cout << "Player " << player << "'s deck has been shuffled.\n";
+        break;
+    case GameEventType::CARDS_DRAWN:
+        cout << "Player " << player << " has drawn " << event.value << " cards." << endl;
+        break;
+    case GameEventType::DECK_EMPTY:
+        cout << "Player " << player << "'s deck is empty.\n";
+        break;
+    case GameEventType::CARD_NOT_IN_HAND:
+        cout << "Player " << player << " does not have the specified card in hand." << endl;
+        break;
+    case GameEventType::POKEMON_PLAYED:
+        cout << "Player " << player << " played "
+            << "\033[1;32m" << CardTable::getName(event.card) << resetColor
+            << (event.detail == ACTIVE_SLOT ? " to their active spot." : " to their bench.") << endl;
+        break;
+    case GameEventType::NO_SPOT:
+        cout << "Player " << player << " cannot play " << CardTable::getName(event.card) << " due to no available spots." << endl;
+        break;
+    case GameEventType::NO_ENERGY:
+        cout << "Player " << player << " does not have energy available.\n";
+        break;
+    case GameEventType::ENERGY_FULL:
+        cout << "Player " << player << " cannot attach more energy to " << CardTable::getName(event.card) << ".\n";
+        break;
+    case GameEventType::NO_TARGET:
+        cout << "Player " << player << " has no Pokemon in slot " << event.detail << " to attach energy to.\n";
+        break;
+    case GameEventType::ENERGY_ATTACHED:
+        cout << "Player " << player << " attached "
+            << energyColor(event.energy) << event.energy << resetColor
+            << " energy to " << pokemonColor << CardTable::getName(event.card)
+            << resetColor << ".\n";
+        break;
+    case GameEventType::ATTACK_NOT_POSSIBLE:
+        cout << "Attack not possible: One or both active Pokemon are missing!" << endl;
+        break;
+    case GameEventType::ATTACK:
+        cout << "Player " << player << "'s " << pokemonColor << CardTable::getName(event.card) << resetColor << " "
+            << "\033[31mattacks\033[0m "
+            << pokemonColor << CardTable::getName(event.target) << resetColor << " "
+            << "using \033[31m" << CardTable::getAttack(event.card, event.detail).name << "\033[0m for \033[31m" << event.value << "\033[0m damage!" << endl;
+        break;
+    case GameEventType::KNOCKED_OUT:
+        cout << CardTable::getName(event.card) << " is knocked out!" << endl;
+        break;
+    case GameEventType::PROMOTED:
+        cout << CardTable::getName(event.card) << " moves to the active spot!" << endl;
+        break;
+    case GameEventType::BENCH_SLOT_EMPTY:
+        cout << "Player " << player << " has no Pokemon in bench slot " << event.detail << " to move to the active spot.\n";
+        break;
+    case GameEventType::TURN_ENDED:
+        cout << "Player " << player << "'s \033[35mturn\033[0m has \033[35mended\033[0m." << endl;
+        break;
+    case GameEventType::ENERGY_GENERATED:
+        cout << energyColor(event.energy) << event.energy << resetColor << " has been added to Player " << player << endl;
+        break;
+    case GameEventType::WIN_BY_POINTS:
+        cout << "Player " << player << " wins with 3 points!" << endl;
+        break;
+    case GameEventType::NO_POKEMON_LEFT:
+        cout << "Player " << player << " has no Pokemon left. Player " << 2 - event.player << " wins!" << endl;
+        break;
+    case GameEventType::WIN_BY_KNOCKOUT:
+        cout << "Player " << player << " wins the game!" << endl;
+        break;
+    }
+}
+
+void printEvents(VerbosePolicy& log) {
+    GameEvent event;
+    while (log.pop(event)) {
+        printEvent(event);
+    }
+}
@@ -0,0 +1,79 @@
+#ifndef GAMELOG_HPP
+#define GAMELOG_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+#include "GameState.hpp"
+
+using namespace std;
+
+// Everything the game reports while it is played
+enum class GameEventType : uint8_t {
+    FIRST_PLAYER,         // player goes first
+    DECK_SHUFFLED,        // player's deck was shuffled
+    CARDS_DRAWN,          // player drew value cards
+    DECK_EMPTY,           // player tried to draw from an empty deck
+    CARD_NOT_IN_HAND,     // player tried to play a hand index they do not have
+    POKEMON_PLAYED,       // player played card to slot
+    NO_SPOT,              // player could not play card, their bench is full
+    NO_ENERGY,            // player tried to attach energy they do not have
+    ENERGY_FULL,          // card of player cannot hold more energy
+    NO_TARGET,            // player tried to attach energy to empty slot detail
+    ENERGY_ATTACHED,      // player attached energy to card
+    ATTACK_NOT_POSSIBLE,  // an active spot was empty
+    ATTACK,               // player's card used attack detail on target for value damage
+    KNOCKED_OUT,          // card was knocked out
+    PROMOTED,             // card moved from the bench to the active spot
+    BENCH_SLOT_EMPTY,     // player tried to promote from empty bench slot detail
+    TURN_ENDED,           // player's turn ended
+    ENERGY_GENERATED,     // player got energy for their turn
+    WIN_BY_POINTS,        // player reached 3 points
+    NO_POKEMON_LEFT,      // player has no Pokemon left and lost
+    WIN_BY_KNOCKOUT,      // player knocked out the last Pokemon of their opponent
+};
+
+// A single event: plain data, formatting is left to whoever reads the log
+struct GameEvent {
+    GameEventType type;
+    int player = -1;
+    int detail = -1;          // Slot a card was played to or aimed at, or attack index
+    int value = 0;            // Damage dealt or cards drawn
+    CardID card = NO_CARD;    // Pokemon the event is about
+    CardID target = NO_CARD;  // Defender of an attack
+    char energy = 'X';
+};
+
+// Logging policy of search games. Game only records events under `if constexpr (LogPolicy::enabled)`,
+// so with this policy the logging code is not compiled at all
+struct SilentPolicy {
+    static constexpr bool enabled = false;
+};
+
+// Logging policy of the interactive game: events go to a fixed ring buffer, which the game loop reads and
+// prints between moves. If the reader falls behind the oldest unread events are overwritten
+class VerbosePolicy {
+public:
+    static constexpr bool enabled = true;
+    static constexpr size_t CAPACITY = 256;
+
+    void record(const GameEvent& event);
+    // Takes the oldest unread event, returns false if there is none
+    bool pop(GameEvent& event);
+    size_t size() const;
+    // Events overwritten before they were read
+    uint64_t dropped() const;
+
+private:
+    GameEvent events[CAPACITY] = {};
+    uint64_t written = 0;
+    uint64_t read = 0;
+    uint64_t lost = 0;  // Unread events overwritten by record
+};
+
+// Prints an event the way the game used to report it, with colored card names and energy
+void printEvent(const GameEvent& event);
+// Prints and removes every unread event
+void printEvents(VerbosePolicy& log);
+
+#endif // GAMELOG_HPP
@@ -1,46 +1,54 @@
 #include "GameState.hpp"
-#include "Game.hpp"
-#include "types.hpp"
+#include "CardTable.hpp"
 
 #define GREEN "\033[32m"
 #define RESET "\033[0m"
 
-void displayGameState(const shared_ptr<GameState>& state) {
+// Name of the Pokemon in a spot, or "Empty"
+static string slotName(const GameState& state, int player, int slot) {
+    const ActivePokemon& pokemon = state.slot(player, slot);
+    if (slot != ACTIVE_SLOT && slot > state.playerBenchSize[player]) {
+        return "Empty";
+    }
+    return pokemon.isEmpty() ? "Empty" : GREEN + CardTable::getName(pokemon.card) + RESET;
+}
+
+void displayGameState(const GameState& state) {
     // Display points
-    cout << "Points: " << state->playerPoints[0] << " - " << state->playerPoints[1] << endl;
+    cout << "Points: " << (int)state.playerPoints[0] << " - " << (int)state.playerPoints[1] << endl;
 
     // Display player 2 hand
     cout << "Player 2 Hand: ";
-    for (const auto& card : state->playerHands[1]) {
-        cout << GREEN << card->name << RESET << " ";
+    for (int i = 0; i < state.playerHandSize[1]; i++) {
+        cout << GREEN << CardTable::getName(state.playerHands[1][i]) << RESET << " ";
     }
     cout << endl;
 
     cout << endl;
     /// Display Player 2's Bench (top row)
-    cout << (state->playerBenchSpots[1].size() > 0 ? GREEN + state->playerBenchSpots[1][0]->pokemonCard->name + RESET : "Empty") << "  "
-        << (state->playerBenchSpots[1].size() > 1 ? GREEN + state->playerBenchSpots[1][1]->pokemonCard->name + RESET : "Empty") << "  "
-        << (state->playerBenchSpots[1].size() > 2 ? GREEN + state->playerBenchSpots[1][2]->pokemonCard->name + RESET : "Empty") << endl;
+    cout << slotName(state, 1, 1) << "  "
+        << slotName(state, 1, 2) << "  "
+        << slotName(state, 1, 3) << endl;
 
     // Display Player 2's Active (middle row)
-    cout << state->playerAvailableEnergy[1] << "       "
-        << (state->playerActiveSpots[1] ? GREEN + state->playerActiveSpots[1]->pokemonCard->name + RESET : "Empty") << endl;
+    cout << state.playerAvailableEnergy[1] << "       "
+        << slotName(state, 1, ACTIVE_SLOT) << endl;
 
     // Display Player 1's Active (middle row)
     cout << "        "
-        << (state->playerActiveSpots[0] ? GREEN + state->playerActiveSpots[0]->pokemonCard->name + RESET : "Empty")
-        << "       " << state->playerAvailableEnergy[0] << endl;
+        << slotName(state, 0, ACTIVE_SLOT)
+        << "       " << state.playerAvailableEnergy[0] << endl;
 
     // Display Player 1's Bench (bottom row)
-    cout << (state->playerBenchSpots[0].size() > 0 ? GREEN + state->playerBenchSpots[0][0]->pokemonCard->name + RESET : "Empty") << "  "
-        << (state->playerBenchSpots[0].size() > 1 ? GREEN + state->playerBenchSpots[0][1]->pokemonCard->name + RESET : "Empty") << "  "
-        << (state->playerBenchSpots[0].size() > 2 ? GREEN + state->playerBenchSpots[0][2]->pokemonCard->name + RESET : "Empty") << endl;
+    cout << slotName(state, 0, 1) << "  "
+        << slotName(state, 0, 2) << "  "
+        << slotName(state, 0, 3) << endl;
     cout << endl;
 
     // Display player hands (card names)
     cout << "Player 1 Hand: ";
-    for (const auto& card : state->playerHands[0]) {
-        cout << GREEN << card->name << RESET << " ";
+    for (int i = 0; i < state.playerHandSize[0]; i++) {
+        cout << GREEN << CardTable::getName(state.playerHands[0][i]) << RESET << " ";
     }
     cout << endl;
 
@@ -48,33 +56,29 @@ void displayGameState(const shared_ptr<GameState>& state) {
         cout << "Player " << player + 1 << "'s Pokemon Energy:" << endl;
 
         // Active Pokemon
-        if (state->playerActiveSpots[player]) {
-            cout << "  Active: " << GREEN << state->playerActiveSpots[player]->pokemonCard->name << RESET
+        const ActivePokemon& active = state.playerActiveSpots[player];
+        if (!active.isEmpty()) {
+            cout << "  Active: " << GREEN << CardTable::getName(active.card) << RESET
                 << " | Energy: ";
-            for (char energy : state->playerActiveSpots[player]->currentEnergy) {
-                cout << energy;
-            }
-            cout << endl;
+            cout << energyToString(active.currentEnergy) << endl;
         }
 
         // Bench Pokemon
-        for (const auto& pokemon : state->playerBenchSpots[player]) {
-            cout << "  Bench: " << GREEN << pokemon->pokemonCard->name << RESET << " | Energy: ";
-            for (char energy : pokemon->currentEnergy) {
-                cout << energy;
-            }
-            cout << endl;
+        for (int b = 0; b < state.playerBenchSize[player]; b++) {
+            const ActivePokemon& pokemon = state.playerBenchSpots[player][b];
+            cout << "  Bench: " << GREEN << CardTable::getName(pokemon.card) << RESET << " | Energy: ";
+            cout << energyToString(pokemon.currentEnergy) << endl;
         }
     }
 
     // Display game-over status and winner
-    if (state->gameOver) {
-        if (state->winner != -1) {
-            cout << "Game Over! Player " << state->winner + 1 << " wins!" << endl;
+    if (state.gameOver) {
+        if (state.winner != -1) {
+            cout << "Game Over! Player " << state.winner + 1 << " wins!" << endl;
         }
         else {
             cout << "Game Over! It's a draw!" << endl;
         }
     }
     cout << endl;
-}
\ No newline at end of file
+}
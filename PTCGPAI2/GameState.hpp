@@ -2,40 +2,108 @@
 #define GAMESTATE_HPP
 
 #include <iostream>
-#include <vector>
-#include <memory>
+#include <cstdint>
+#include <type_traits>
 
-// Forward declaration to avoid circular dependency
-class Card;
-class ActivePokemon;
+#include "CardTable.hpp"
+#include "energy.hpp"
+#include "Random.hpp"
 
 using namespace std;
 
+// Fixed capacities of the flat game state
+constexpr int MAX_BENCH_SIZE = 3;         // Bench spots per player
+constexpr int MAX_HAND_SIZE = 20;         // A hand can never hold more than a full deck
+constexpr int MAX_GAME_DECK_SIZE = 20;    // Matches Deck::MAX_DECK_SIZE
+constexpr int MAX_ATTACHED_ENERGY = 127;  // Energy a single Pokemon can hold, keeps every count within its lane
+constexpr int MAX_DECK_ENERGY_TYPES = 3;  // Matches Deck::MAX_ENERGY_TYPES
+constexpr CardID NO_CARD = 0xFFFF;        // Marks an empty Pokemon spot
+constexpr uint8_t NO_CANONICAL_PLAY = MAX_HAND_SIZE;  // Canonical turns play no more cards after attaching energy
+
+// Slot numbering used by actions: 0 is the active spot, 1..MAX_BENCH_SIZE are the bench spots
+constexpr int ACTIVE_SLOT = 0;
+constexpr int NUM_POKEMON_SLOTS = 1 + MAX_BENCH_SIZE;
+
+// A Pokemon in play, its static data lives in the card table
+struct ActivePokemon {
+    EnergyPool currentEnergy = 0;  // Attached energy counted per type
+    CardID card = NO_CARD;
+    int16_t currentHP = 0;
+
+    bool isEmpty() const { return card == NO_CARD; }
+
+    bool canAddEnergy(char energyType) const {
+        return energyTypeIndex(energyType) >= 0 && totalEnergy(currentEnergy) < MAX_ATTACHED_ENERGY;
+    }
+
+    // Method to add energy to the Pokemon's energy pool
+    bool addEnergy(char energyType) {
+        if (!canAddEnergy(energyType)) {
+            return false;
+        }
+        currentEnergy += energyUnit(energyType);
+        return true;
+    }
+
+    // Method to remove energy from the Pokemon's energy pool
+    void removeEnergy(char energyType) {
+        if (energyCount(currentEnergy, energyType) > 0) {
+            currentEnergy -= energyUnit(energyType);
+        }
+    }
+};
+
+// Flat snapshot of a game. Holds no owning pointers, so copying it is a plain memcpy
 struct GameState {
     // Player-related info
-    int playerPoints[2];  // Points of both players
-    int playerHandSize[2];  // Hand sizes of both players
-    shared_ptr<ActivePokemon> playerActiveSpots[2];  // Active Pokemon spots
-    vector<shared_ptr<ActivePokemon>> playerBenchSpots[2];  // Bench Pokemon spots
+    int8_t playerPoints[2] = { 0, 0 };  // Points of both players
+    ActivePokemon playerActiveSpots[2];  // Active Pokemon spots
+    ActivePokemon playerBenchSpots[2][MAX_BENCH_SIZE];  // Bench Pokemon spots
+    uint8_t playerBenchSize[2] = { 0, 0 };
 
     // Available energy for both players
-    char playerAvailableEnergy[2];  // Available energy for both players
+    char playerAvailableEnergy[2] = { 'X', 'X' };
+
+    // Energy types each deck generates, copied from the decks so endTurn needs no lookup
+    char playerEnergyTypes[2][MAX_DECK_ENERGY_TYPES] = {};
+    uint8_t playerEnergyTypeCount[2] = { 0, 0 };
 
     // Player hands
-    vector<shared_ptr<Card>> playerHands[2];  // Player hands
+    CardID playerHands[2][MAX_HAND_SIZE] = {};
+    uint8_t playerHandSize[2] = { 0, 0 };  // Hand sizes of both players
 
-    // Decks
-    vector<shared_ptr<Card>> playerDecks[2];  // Original unchanging decks
-    vector<shared_ptr<Card>> gameDecks[2];  // Shuffled and modified decks
+    // Shuffled and modified decks
+    CardID gameDecks[2][MAX_GAME_DECK_SIZE] = {};
+    uint8_t gameDeckSize[2] = { 0, 0 };
 
     // Game-related info
-    bool gameOver = 0;  // Flag indicating whether the game is over
-    int currentPlayer = -1;  // Index of the current player (0 or 1)
-    int winner;  // Index of the winner (0 for Player 1, 1 for Player 2, -1 if no winner yet)
+    bool gameOver = false;  // Flag indicating whether the game is over
+    int8_t currentPlayer = -1;  // Index of the current player (0 or 1)
+    int8_t winner = -1;  // Index of the winner (0 for Player 1, 1 for Player 2, -1 if no winner yet)
+
+    int16_t damageDealt[2] = { 0, 0 };  // Total damage dealt by each player
+
+    uint64_t zobristKey = 0;  // Position identity, kept up to date by Game (see Zobrist.hpp)
+    int32_t evaluation = 0;   // Static evaluation for player 0, kept up to date by Game (see Evaluation.hpp)
 
-    vector<int> damageDealt = { 0, 0 };  // Total damage dealt by each player
+    // 0 while getCanonicalActions may still play cards this turn, NO_CANONICAL_PLAY once energy was attached
+    uint8_t canonicalPlayFrom = 0;
+
+    // Generator of the game's shuffles and energy, copied with the state so a snapshot replays the same game.
+    // Not part of the position: searches must not read the future from it
+    Rng rng;
+
+    // Access a Pokemon spot by slot number (ACTIVE_SLOT or 1..MAX_BENCH_SIZE)
+    ActivePokemon& slot(int player, int slot) {
+        return slot == ACTIVE_SLOT ? playerActiveSpots[player] : playerBenchSpots[player][slot - 1];
+    }
+    const ActivePokemon& slot(int player, int slot) const {
+        return slot == ACTIVE_SLOT ? playerActiveSpots[player] : playerBenchSpots[player][slot - 1];
+    }
 };
 
-void displayGameState(const shared_ptr<GameState>& state);
+static_assert(is_trivially_copyable_v<GameState>, "GameState must stay memcpy-able");
+
+void displayGameState(const GameState& state);
 
-#endif //GAMESTATE.HPP
\ No newline at end of file
+#endif //GAMESTATE.HPP
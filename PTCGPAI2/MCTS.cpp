@@ -0,0 +1,409 @@
+#include "MCTS.hpp"
+#include "Game.hpp"
+#include "CardTable.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+MCTS::MCTS(const MCTSOptions& options)
+    : options(options), rng(options.seed != 0 ? Rng(options.seed) : Rng::fromRandomDevice()) {
+    capacity = max<size_t>(2, options.memoryMB * 1024 * 1024 / (sizeof(MCTSNode) + sizeof(uint32_t)));
+    nodes.reset(new MCTSNode[capacity]);
+    freeNodes.reserve(capacity);
+}
+
+// Takes a node from the free list, or returns NO_NODE and flags the pool once it is empty
+uint32_t MCTS::allocateNode() {
+    size_t index = nextFree++;
+    if (index >= freeNodes.size()) {
+        poolExhausted = true;
+        return NO_NODE;
+    }
+    return freeNodes[index];
+}
+
+// Checks whether a move is legal in the current position. Energy is random, so the same path can lead
+// to positions with different moves and children made in one playout may not apply in the next
+static bool containsMove(const MoveList& moves, const Action& action) {
+    for (const Action& move : moves) {
+        if (move == action) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t MCTS::expand(uint32_t parent, const MoveList& moves, int player) {
+    if (poolExhausted) {
+        return NO_NODE;
+    }
+
+    MCTSNode& parentNode = nodes[parent];
+
+    // Another thread is adding a child here, select among the existing ones instead
+    bool expected = false;
+    if (!parentNode.expanding.compare_exchange_strong(expected, true, memory_order_acquire)) {
+        return NO_NODE;
+    }
+
+    // Find the first legal move without a child
+    int untried = -1;
+    for (int m = 0; m < (int)moves.size() && untried < 0; m++) {
+        bool tried = false;
+        for (uint32_t c = parentNode.firstChild.load(memory_order_acquire); c != NO_NODE; c = nodes[c].nextSibling) {
+            if (nodes[c].action == moves[m]) {
+                tried = true;
+                break;
+            }
+        }
+        if (!tried) {
+            untried = m;
+        }
+    }
+
+    uint32_t child = untried < 0 ? NO_NODE : allocateNode();
+    if (child != NO_NODE) {
+        MCTSNode& childNode = nodes[child];
+        childNode.visits.store(0, memory_order_relaxed);
+        childNode.reward.store(0, memory_order_relaxed);
+        childNode.firstChild.store(NO_NODE, memory_order_relaxed);
+        childNode.expanding.store(false, memory_order_relaxed);
+        childNode.alive = true;
+        childNode.action = moves[untried];
+        childNode.player = (int8_t)player;
+        childNode.nextSibling = parentNode.firstChild.load(memory_order_relaxed);
+
+        // Publish the fully initialized child
+        parentNode.firstChild.store(child, memory_order_release);
+    }
+
+    parentNode.expanding.store(false, memory_order_release);
+    return child;
+}
+
+uint32_t MCTS::selectChild(uint32_t parent, const MoveList& moves) const {
+    const double logParentVisits = log((double)max<uint32_t>(1, nodes[parent].visits.load(memory_order_relaxed)));
+
+    uint32_t best = NO_NODE;
+    double bestScore = -1.0;
+    for (uint32_t c = nodes[parent].firstChild.load(memory_order_acquire); c != NO_NODE; c = nodes[c].nextSibling) {
+        const MCTSNode& child = nodes[c];
+        if (!containsMove(moves, child.action)) {
+            continue;
+        }
+
+        // Playouts still in flight count as visits without reward, which steers other threads elsewhere
+        const uint32_t visits = child.visits.load(memory_order_relaxed);
+        if (visits == 0) {
+            return c;
+        }
+        const double value = child.reward.load(memory_order_relaxed) / (2.0 * visits);
+        const double score = value + options.exploration * sqrt(logParentVisits / visits);
+        if (score > bestScore) {
+            bestScore = score;
+            best = c;
+        }
+    }
+    return best;
+}
+
+// Greedy playout move: knockouts, then the strongest attack, energy on the active Pokemon, other energy,
+// plays and END_TURN last. Ties are broken at random
+static Action pickGreedyMove(const GameState& state, const MoveList& moves, Rng& rng) {
+    const ActivePokemon& attacker = state.playerActiveSpots[state.currentPlayer];
+    const ActivePokemon& defender = state.playerActiveSpots[1 - state.currentPlayer];
+
+    int bestScore = -1;
+    int bestCount = 0;
+    Action best = moves[0];
+    for (const Action& move : moves) {
+        int score = 0;
+        switch (move.type) {
+        case ActionType::ATTACK: {
+            int damage = CardTable::getStats(attacker.card).attacks[move.attack].damage;
+            score = !defender.isEmpty() && damage >= defender.currentHP ? 10000 : 1000 + damage;
+            break;
+        }
+        case ActionType::ENERGY: score = move.target == ACTIVE_SLOT ? 600 : 500; break;
+        case ActionType::PLAY:
+        case ActionType::BENCH:  score = 400; break;
+        default: break;
+        }
+
+        if (score > bestScore) {
+            bestScore = score;
+            bestCount = 1;
+            best = move;
+        }
+        else if (score == bestScore && rng.below(++bestCount) == 0) {
+            best = move;
+        }
+    }
+    return best;
+}
+
+// Plays the game out and returns the winner, -1 for a draw
+int MCTS::rollout(Game& game, Rng& rng) const {
+    for (int step = 0; step < options.maxRolloutActions && !game.getGameState().gameOver; step++) {
+        MoveList moves = getLegalActions(game);
+        if (moves.empty()) {
+            break;
+        }
+
+        Action move = options.rollout == RolloutPolicy::GREEDY
+            ? pickGreedyMove(game.getGameState(), moves, rng)
+            : moves[rng.below((uint32_t)moves.size())];
+        applyAction(game, move);
+    }
+
+    const GameState& state = game.getGameState();
+    if (state.gameOver) {
+        return state.winner;
+    }
+
+    // Unfinished playouts go to whoever has more points
+    if (state.playerPoints[0] != state.playerPoints[1]) {
+        return state.playerPoints[0] > state.playerPoints[1] ? 0 : 1;
+    }
+    return -1;
+}
+
+void MCTS::runIteration(Rng& rng) {
+    // The playout draws its own energy, the generator of the real game would tell it the future
+    GameState start = rootState;
+    start.rng = rng.split();
+    Game game(start, true);
+    vector<uint32_t> path;
+    path.push_back(ROOT_NODE);
+    nodes[ROOT_NODE].visits++;
+
+    // Selection and expansion: walk down by UCT until a new child is added or the tree ends
+    uint32_t node = ROOT_NODE;
+    while (!game.getGameState().gameOver) {
+        MoveList moves = getLegalActions(game);
+        if (moves.empty()) {
+            break;
+        }
+
+        uint32_t child = expand(node, moves, game.getGameState().currentPlayer);
+        const bool expanded = child != NO_NODE;
+        if (!expanded) {
+            child = selectChild(node, moves);
+            if (child == NO_NODE) {
+                break;
+            }
+        }
+
+        nodes[child].visits++;  // Virtual loss until the playout is backed up
+        applyAction(game, nodes[child].action);
+        path.push_back(child);
+        node = child;
+
+        if (expanded) {
+            break;
+        }
+    }
+
+    const int winner = rollout(game, rng);
+
+    // Backpropagation, each node is scored for the player who made its move
+    for (uint32_t n : path) {
+        const int player = nodes[n].player;
+        nodes[n].reward += winner == -1 ? 1 : (winner == player ? 2 : 0);
+    }
+}
+
+// Frees the least-visited subtrees until half of the pool is free again. Only called while no thread searches.
+// Pruned nodes keep their statistics and become leaves that can be expanded again
+void MCTS::recycle() {
+    vector<bool> rootChild(capacity, false);
+    for (uint32_t c = nodes[ROOT_NODE].firstChild.load(); c != NO_NODE; c = nodes[c].nextSibling) {
+        rootChild[c] = true;
+    }
+
+    vector<uint32_t> candidates;
+    for (uint32_t i = 0; i < capacity; i++) {
+        if (nodes[i].alive && i != ROOT_NODE && !rootChild[i] && nodes[i].firstChild.load() != NO_NODE) {
+            candidates.push_back(i);
+        }
+    }
+    sort(candidates.begin(), candidates.end(), [this](uint32_t a, uint32_t b) { return nodes[a].visits.load() < nodes[b].visits.load(); });
+
+    size_t freed = 0;
+    vector<uint32_t> stack;
+    for (uint32_t candidate : candidates) {
+        if (freed >= capacity / 2) {
+            break;
+        }
+        // Already removed with a less visited ancestor
+        if (!nodes[candidate].alive) {
+            continue;
+        }
+
+        stack.push_back(nodes[candidate].firstChild.load());
+        nodes[candidate].firstChild = NO_NODE;
+        while (!stack.empty()) {
+            uint32_t first = stack.back();
+            stack.pop_back();
+            for (uint32_t c = first; c != NO_NODE; c = nodes[c].nextSibling) {
+                nodes[c].alive = false;
+                freed++;
+                if (nodes[c].firstChild.load() != NO_NODE) {
+                    stack.push_back(nodes[c].firstChild.load());
+                }
+            }
+        }
+    }
+
+    rebuildFreeNodes();
+}
+
+void MCTS::rebuildFreeNodes() {
+    freeNodes.clear();
+    for (uint32_t i = 0; i < capacity; i++) {
+        if (!nodes[i].alive) {
+            freeNodes.push_back(i);
+        }
+    }
+    nextFree = 0;
+    poolExhausted = freeNodes.empty();
+}
+
+void MCTS::resetTree() {
+    for (uint32_t i = 0; i < capacity; i++) {
+        nodes[i].alive = false;
+    }
+    MCTSNode& root = nodes[ROOT_NODE];
+    root.visits = 0;
+    root.reward = 0;
+    root.firstChild = NO_NODE;
+    root.expanding = false;
+    root.alive = true;
+    root.player = -1;
+    freeNodes.clear();
+    for (uint32_t i = 1; i < capacity; i++) {
+        freeNodes.push_back(i);
+    }
+    nextFree = 0;
+    poolExhausted = false;
+}
+
+void MCTS::advance(const Action& action) {
+    uint32_t kept = NO_NODE;
+    if (treeKept) {
+        for (uint32_t c = nodes[ROOT_NODE].firstChild.load(); c != NO_NODE; c = nodes[c].nextSibling) {
+            if (nodes[c].action == action) {
+                kept = c;
+                break;
+            }
+        }
+    }
+    treeKept = kept != NO_NODE;
+    if (!treeKept) {
+        return;
+    }
+
+    // Mark the kept subtree, every other node is freed
+    vector<bool> inSubtree(capacity, false);
+    vector<uint32_t> stack;
+    stack.push_back(nodes[kept].firstChild.load());
+    while (!stack.empty()) {
+        uint32_t first = stack.back();
+        stack.pop_back();
+        for (uint32_t c = first; c != NO_NODE; c = nodes[c].nextSibling) {
+            inSubtree[c] = true;
+            if (nodes[c].firstChild.load() != NO_NODE) {
+                stack.push_back(nodes[c].firstChild.load());
+            }
+        }
+    }
+    for (uint32_t i = 0; i < capacity; i++) {
+        nodes[i].alive = inSubtree[i];
+    }
+
+    // The kept node becomes the root, which always lives in ROOT_NODE
+    MCTSNode& root = nodes[ROOT_NODE];
+    root.visits = nodes[kept].visits.load();
+    root.reward = nodes[kept].reward.load();
+    root.firstChild = nodes[kept].firstChild.load();
+    root.expanding = false;
+    root.alive = true;
+    root.player = -1;
+
+    rebuildFreeNodes();
+}
+
+Action MCTS::search(const GameState& state) {
+    rootState = state;
+
+    // Fresh tree with only the root in use, unless advance kept the subtree of this position
+    if (!treeKept) {
+        resetTree();
+    }
+    treeKept = true;
+    MCTSNode& root = nodes[ROOT_NODE];
+    iterationsStarted = 0;
+
+    const auto deadline = chrono::steady_clock::now() + chrono::milliseconds(options.timeLimitMs);
+    bool canRecycle = true;
+    bool budgetLeft = true;
+
+    while (budgetLeft) {
+        atomic<bool> outOfBudget(false);
+        auto worker = [&](Rng rng) {
+            while (true) {
+                if (options.timeLimitMs > 0 && chrono::steady_clock::now() >= deadline) {
+                    outOfBudget = true;
+                    return;
+                }
+                if (iterationsStarted++ >= options.iterations) {
+                    outOfBudget = true;
+                    return;
+                }
+                runIteration(rng);
+
+                // Stop all threads so the full pool can be recycled
+                if (poolExhausted && canRecycle) {
+                    return;
+                }
+            }
+        };
+
+        vector<thread> threads;
+        for (int t = 1; t < options.threads; t++) {
+            threads.emplace_back(worker, rng.split());
+        }
+        worker(rng.split());
+        for (thread& t : threads) {
+            t.join();
+        }
+
+        budgetLeft = !outOfBudget;
+        if (budgetLeft && poolExhausted) {
+            recycle();
+            // The tree is down to the root and its children and still does not fit, keep searching without growing
+            canRecycle = !poolExhausted;
+        }
+    }
+
+    iterationsDone = (uint64_t)min<int64_t>(iterationsStarted, options.iterations);
+    nodesInUse = 0;
+    for (uint32_t i = 0; i < capacity; i++) {
+        nodesInUse += nodes[i].alive;
+    }
+
+    // Play the most visited legal move
+    Game game(state);
+    MoveList moves = getLegalActions(game);
+    Action best = moves.empty() ? Action(ActionType::END_TURN) : moves[0];
+    uint32_t bestVisits = 0;
+    for (uint32_t c = root.firstChild.load(); c != NO_NODE; c = nodes[c].nextSibling) {
+        if (containsMove(moves, nodes[c].action) && nodes[c].visits > bestVisits) {
+            bestVisits = nodes[c].visits;
+            best = nodes[c].action;
+        }
+    }
+    return best;
+}
@@ -0,0 +1,99 @@
+#ifndef MCTS_HPP
+#define MCTS_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Action.hpp"
+#include "GameState.hpp"
+#include "Random.hpp"
+
+using namespace std;
+
+class Game;
+
+enum class RolloutPolicy : uint8_t {
+    RANDOM,  // Uniformly random legal moves
+    GREEDY   // Knockouts, then the strongest attack, energy, plays and END_TURN last
+};
+
+struct MCTSOptions {
+    int iterations = 10000;          // Playout budget for one search
+    int64_t timeLimitMs = 0;         // Optional wall-clock budget, 0 means none
+    int threads = 1;                 // Threads sharing the tree
+    size_t memoryMB = 64;            // Node memory, least-visited subtrees are recycled when it runs out
+    double exploration = 1.41;       // UCT exploration constant
+    RolloutPolicy rollout = RolloutPolicy::RANDOM;
+    int maxRolloutActions = 500;     // Playouts longer than this are scored from the evaluation
+    uint64_t seed = 0;               // Seed of the playouts, 0 seeds from the system
+};
+
+constexpr uint32_t NO_NODE = UINT32_MAX;
+
+// A node of the search tree. Statistics are atomic so any number of threads can update them
+struct MCTSNode {
+    atomic<uint32_t> visits{ 0 };            // Completed playouts plus playouts still in flight (virtual loss)
+    atomic<uint32_t> reward{ 0 };            // 2 per win and 1 per draw for the player who made the move
+    atomic<uint32_t> firstChild{ NO_NODE };
+    uint32_t nextSibling = NO_NODE;          // Set before the node is linked in, never changed while searching
+    atomic<bool> expanding{ false };         // Held while a thread adds a child
+    bool alive = false;
+    Action action = Action(ActionType::ROOT); // Move that led to this node
+    int8_t player = -1;                       // Player who made that move
+};
+
+// Monte Carlo Tree Search with UCT selection, one expansion per playout and tree parallelism
+class MCTS {
+public:
+    explicit MCTS(const MCTSOptions& options = MCTSOptions());
+
+    // Searches the position and returns the most visited move. After advance, the search continues
+    // from the kept subtree, so state must be the position the advanced moves lead to
+    Action search(const GameState& state);
+
+    // Keeps the subtree under a move played from the searched position as the tree of the next search,
+    // with its statistics. Call it for every move played, including the opponent's. A move the tree
+    // never tried discards the tree
+    void advance(const Action& action);
+
+    // Makes the next search start from a fresh tree, for a position that does not follow from the last one
+    void discardTree() { treeKept = false; }
+
+    // Statistics of the last search
+    uint64_t getIterations() const { return iterationsDone; }
+    size_t getNodeCount() const { return nodesInUse; }
+    size_t getCapacity() const { return capacity; }
+    uint32_t getRootVisits() const { return nodes[ROOT_NODE].visits.load(); }
+
+private:
+    static constexpr uint32_t ROOT_NODE = 0;
+
+    MCTSOptions options;
+    unique_ptr<MCTSNode[]> nodes;
+    size_t capacity = 0;
+
+    // Free nodes, handed out lock-free by bumping nextFree. Refilled by recycle() while no thread searches
+    vector<uint32_t> freeNodes;
+    atomic<size_t> nextFree{ 0 };
+    atomic<bool> poolExhausted{ false };
+
+    GameState rootState;
+    Rng rng;                // Splits off the generator of every worker thread
+    bool treeKept = false;  // The tree holds the subtree of the position the next search starts from
+    atomic<int64_t> iterationsStarted{ 0 };
+    uint64_t iterationsDone = 0;
+    size_t nodesInUse = 0;
+
+    uint32_t allocateNode();
+    void resetTree();
+    void rebuildFreeNodes();
+    void runIteration(Rng& rng);
+    uint32_t selectChild(uint32_t parent, const MoveList& moves) const;
+    uint32_t expand(uint32_t parent, const MoveList& moves, int player);
+    int rollout(Game& game, Rng& rng) const;
+    void recycle();
+};
+
+#endif // MCTS_HPP
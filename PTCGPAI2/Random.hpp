@@ -0,0 +1,76 @@
+#ifndef RANDOM_HPP
+#define RANDOM_HPP
+
+#include <cstdint>
+#include <random>
+#include <utility>
+
+using namespace std;
+
+// PCG32 (XSH RR) generator: 16 bytes, no system calls and no shared state, so every game and every worker
+// thread owns one. The same seed and stream always give the same numbers, on every platform, which lets
+// a seeded game be replayed exactly
+struct Rng {
+    uint64_t state = 0x853C49E6748FEA9Bull;
+    uint64_t increment = 0xDA3E39CB94B95BDBull;  // Selects the stream, always odd
+
+    Rng() = default;
+
+    // Generators with the same seed but different streams give independent sequences
+    explicit Rng(uint64_t seed, uint64_t stream = 0) {
+        state = 0;
+        increment = (stream << 1) | 1;
+        next();
+        state += seed;
+        next();
+    }
+
+    // Seed from the system, for games that do not need to be replayed
+    static Rng fromRandomDevice() {
+        random_device rd;
+        return Rng(((uint64_t)rd() << 32) | rd(), ((uint64_t)rd() << 32) | rd());
+    }
+
+    uint32_t next() {
+        const uint64_t old = state;
+        state = old * 6364136223846793005ull + increment;
+        const uint32_t xorShifted = (uint32_t)(((old >> 18) ^ old) >> 27);
+        const uint32_t rotation = (uint32_t)(old >> 59);
+        return (xorShifted >> rotation) | (xorShifted << ((0u - rotation) & 31));
+    }
+
+    uint64_t next64() {
+        const uint64_t high = next();
+        return (high << 32) | next();
+    }
+
+    // Uniform in [0, bound), without modulo bias
+    uint32_t below(uint32_t bound) {
+        uint64_t product = (uint64_t)next() * bound;
+        uint32_t low = (uint32_t)product;
+        if (low < bound) {
+            const uint32_t threshold = (0u - bound) % bound;
+            while (low < threshold) {
+                product = (uint64_t)next() * bound;
+                low = (uint32_t)product;
+            }
+        }
+        return (uint32_t)(product >> 32);
+    }
+
+    // A new generator on its own stream, for a worker thread or a game started from this one
+    Rng split() {
+        const uint64_t seed = next64();
+        return Rng(seed, next64());
+    }
+
+    // Fisher-Yates shuffle. std::shuffle differs between standard libraries, this gives the same order everywhere
+    template <typename T>
+    void shuffle(T* first, int count) {
+        for (int i = count - 1; i > 0; i--) {
+            swap(first[i], first[below(i + 1)]);
+        }
+    }
+};
+
+#endif // RANDOM_HPP
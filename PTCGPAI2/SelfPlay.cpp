@@ -0,0 +1,95 @@
+#include "SelfPlay.hpp"
+#include "Game.hpp"
+#include "Action.hpp"
+#include "TranspositionTable.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+constexpr size_t SELFPLAY_TABLE_MB = 4;  // Transposition table of each game thread
+
+ConfidenceInterval wilsonInterval(int successes, int trials, double z) {
+    ConfidenceInterval interval;
+    if (trials <= 0) {
+        interval.high = 1.0;
+        return interval;
+    }
+
+    const double n = trials;
+    const double p = successes / n;
+    const double z2 = z * z;
+    const double center = (p + z2 / (2 * n)) / (1 + z2 / n);
+    const double halfWidth = z * sqrt(p * (1 - p) / n + z2 / (4 * n * n)) / (1 + z2 / n);
+    interval.low = max(0.0, center - halfWidth);
+    interval.high = min(1.0, center + halfWidth);
+    return interval;
+}
+
+SelfPlayResult runSelfPlay(shared_ptr<Deck> deck1, shared_ptr<Deck> deck2, const SelfPlayOptions& options) {
+    const int threadCount = options.threads > 0 ? options.threads : max(1u, thread::hardware_concurrency());
+    const auto start = chrono::steady_clock::now();
+
+    SelfPlayResult total;
+    total.seed = options.seed != 0 ? options.seed : Rng::fromRandomDevice().next64();
+    mutex totalLock;
+    atomic<int> nextGame(0);
+
+    auto worker = [&]() {
+        TranspositionTable table(SELFPLAY_TABLE_MB);
+        SelfPlayResult local;
+
+        for (int g = nextGame++; g < options.games; g = nextGame++) {
+            Game game(deck1, deck2, Rng(total.seed, g));
+            const int firstPlayer = game.getGameState().currentPlayer;
+            table.clear();
+
+            int turns = 0;
+            while (!game.isWinner() && turns < options.maxGameTurns) {
+                table.newSearch();
+                Action action = iterativeDeepening(game.getGameState(), options.limits, table).bestAction;
+                applyAction(game, action);
+                local.totalActions++;
+                if (endsTurn(action)) {
+                    turns++;
+                }
+            }
+
+            const GameState& state = game.getGameState();
+            local.games++;
+            local.totalTurns += turns;
+            if (state.gameOver && state.winner >= 0) {
+                local.wins[state.winner]++;
+                local.firstPlayerWins += state.winner == firstPlayer;
+            }
+            else {
+                local.unfinished++;
+            }
+        }
+
+        lock_guard<mutex> guard(totalLock);
+        total.games += local.games;
+        total.wins[0] += local.wins[0];
+        total.wins[1] += local.wins[1];
+        total.unfinished += local.unfinished;
+        total.firstPlayerWins += local.firstPlayerWins;
+        total.totalTurns += local.totalTurns;
+        total.totalActions += local.totalActions;
+    };
+
+    vector<thread> threads;
+    for (int t = 1; t < threadCount; t++) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (thread& t : threads) {
+        t.join();
+    }
+
+    total.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return total;
+}
@@ -0,0 +1,56 @@
+#ifndef SELFPLAY_HPP
+#define SELFPLAY_HPP
+
+#include <cstdint>
+#include <memory>
+
+#include "aiFunctions.hpp"
+
+using namespace std;
+
+class Deck;
+
+struct SelfPlayOptions {
+    int games = 100;
+    int threads = 0;          // 0 uses every core
+    int maxGameTurns = 50;    // Games still running after this many turns are counted as unfinished
+    uint64_t seed = 0;        // Game i is dealt from stream i of this seed, 0 picks a seed at random
+    SearchLimits limits;      // Search of every move, by both players
+
+    // Batches need many games, so each move gets a small node budget instead of the interactive defaults
+    SelfPlayOptions() {
+        limits.maxTurns = 2;
+        limits.maxDepth = 20;
+        limits.maxNodes = 20000;
+    }
+};
+
+struct SelfPlayResult {
+    int games = 0;
+    int wins[2] = { 0, 0 };      // Games won by the first and the second deck
+    int unfinished = 0;          // Games that hit maxGameTurns
+    int firstPlayerWins = 0;     // Games won by whoever moved first, whichever deck that was
+    uint64_t totalTurns = 0;
+    uint64_t totalActions = 0;
+    double seconds = 0.0;        // Wall-clock time of the whole batch
+    uint64_t seed = 0;           // Seed the games were dealt from, passing it back in replays the batch
+
+    double averageTurns() const { return games > 0 ? (double)totalTurns / games : 0.0; }
+    double gamesPerSecond() const { return seconds > 0.0 ? games / seconds : 0.0; }
+};
+
+struct ConfidenceInterval {
+    double low = 0.0;
+    double high = 0.0;
+};
+
+// Wilson score interval of a rate, z = 1.96 gives 95% confidence. Unlike the normal approximation it stays
+// inside [0, 1] and is usable for rates close to 0 or 1 and for few games
+ConfidenceInterval wilsonInterval(int successes, int trials, double z = 1.96);
+
+// Plays options.games silent games of deck1 against deck2, engine against engine, on options.threads threads.
+// Every thread has its own transposition table, so games never wait on each other. With a node budget
+// instead of a time limit the results only depend on the seed, not on the threads
+SelfPlayResult runSelfPlay(shared_ptr<Deck> deck1, shared_ptr<Deck> deck2, const SelfPlayOptions& options);
+
+#endif // SELFPLAY_HPP
@@ -0,0 +1,279 @@
+#include "Tournament.hpp"
+#include "deck.hpp"
+#include "Random.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+// File layout: magic, format version, engine version, entry count, then one record per entry
+constexpr uint32_t TOURNAMENT_FILE_MAGIC = 0x54474750;  // "PGGT"
+constexpr uint32_t TOURNAMENT_FILE_VERSION = 1;
+constexpr int TOURNAMENT_SAVE_SECONDS = 300;  // How often a running tournament writes its cache
+
+static uint64_t mixKey(uint64_t key, uint64_t word) {
+    uint64_t z = key ^ (word + 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+shared_ptr<Deck> buildDeck(const CardCollection& cardCollection, const vector<string>& cardNames) {
+    shared_ptr<Deck> deck = make_shared<Deck>();
+    for (const string& cardName : cardNames) {
+        const Card* card = cardCollection.findCardByName(cardName);
+        if (!card) {
+            cout << "Card " << cardName << " not found!" << endl;
+            return nullptr;
+        }
+        if (!deck->addCard(make_shared<Card>(*card))) {
+            return nullptr;
+        }
+    }
+    if (deck->cards.empty() || !deck->verifyDeck()) {
+        return nullptr;
+    }
+    return deck;
+}
+
+vector<string> splitCardNames(const string& cardNames) {
+    vector<string> names;
+    stringstream stream(cardNames);
+    string cardName;
+    while (getline(stream, cardName, ',')) {
+        const size_t first = cardName.find_first_not_of(" \t\r");
+        if (first != string::npos) {
+            names.push_back(cardName.substr(first, cardName.find_last_not_of(" \t\r") - first + 1));
+        }
+    }
+    return names;
+}
+
+uint64_t deckHash(const Deck& deck) {
+    // One line per card with every field the rules use, sorted so the order of the cards does not matter
+    vector<string> cards;
+    for (const auto& card : deck.cards) {
+        stringstream line;
+        line << card->name << '|' << card->hp << '|' << card->type << '|' << card->stage << '|'
+            << card->weakness << '|' << card->retreatCost << '|' << card->abilID;
+        for (const Attack& attack : card->attacks) {
+            line << '|' << attack.name << ',' << attack.damage << ',' << attack.toEnergyString() << ',' << attack.effectId;
+        }
+        cards.push_back(line.str());
+    }
+    sort(cards.begin(), cards.end());
+
+    uint64_t hash = mixKey(0, cards.size());
+    for (const string& card : cards) {
+        for (unsigned char c : card) {
+            hash = mixKey(hash, c);
+        }
+        hash = mixKey(hash, '\n');
+    }
+
+    // The energy types decide which energy each turn generates, their order is kept as the deck chose it
+    const vector<char> energyTypes = deck.getEnergyTypes();
+    hash = mixKey(hash, energyTypes.size());
+    for (char type : energyTypes) {
+        hash = mixKey(hash, (unsigned char)type);
+    }
+    return hash;
+}
+
+bool loadDeckList(const string& path, const CardCollection& cardCollection, vector<TournamentDeck>& decks) {
+    ifstream file(path);
+    if (!file) {
+        cout << "Cannot read deck list " << path << endl;
+        return false;
+    }
+
+    string line;
+    int lineNumber = 0;
+    while (getline(file, line)) {
+        lineNumber++;
+        const size_t first = line.find_first_not_of(" \t\r");
+        if (first == string::npos || line[first] == '#') {
+            continue;
+        }
+
+        const size_t separator = line.find(':');
+        if (separator == string::npos || separator == first) {
+            cout << path << ":" << lineNumber << ": expected \"name: card,card,...\"" << endl;
+            return false;
+        }
+
+        TournamentDeck deck;
+        deck.name = line.substr(first, line.find_last_not_of(" \t", separator - 1) - first + 1);
+        deck.deck = buildDeck(cardCollection, splitCardNames(line.substr(separator + 1)));
+        if (!deck.deck) {
+            cout << path << ":" << lineNumber << ": deck " << deck.name << " is not valid" << endl;
+            return false;
+        }
+        deck.hash = deckHash(*deck.deck);
+        decks.push_back(deck);
+    }
+    return true;
+}
+
+uint64_t TournamentCache::matchKey(uint64_t deck1Hash, uint64_t deck2Hash, const SelfPlayOptions& options) {
+    const SearchLimits& limits = options.limits;
+    uint64_t key = mixKey(deck1Hash, deck2Hash);
+    key = mixKey(key, ENGINE_VERSION);
+    key = mixKey(key, ((uint64_t)(uint32_t)options.games << 32) | (uint32_t)options.maxGameTurns);
+    key = mixKey(key, options.seed);
+    key = mixKey(key, ((uint64_t)(uint32_t)limits.maxDepth << 32) | (uint32_t)limits.maxTurns);
+    key = mixKey(key, (uint64_t)limits.timeLimitMs);
+    key = mixKey(key, limits.maxNodes);
+    key = mixKey(key, ((uint64_t)(uint32_t)limits.threads << 32) | (uint32_t)limits.endgameTurns);
+    key = mixKey(key, (uint64_t)limits.canonicalTurns | ((uint64_t)(limits.endgame != nullptr) << 1));
+    return key;
+}
+
+bool TournamentCache::find(uint64_t key, SelfPlayResult& result) const {
+    const auto it = entries.find(key);
+    if (it == entries.end()) {
+        return false;
+    }
+    result = it->second;
+    return true;
+}
+
+void TournamentCache::store(uint64_t key, const SelfPlayResult& result) {
+    entries[key] = result;
+}
+
+bool TournamentCache::load(const string& path) {
+    ifstream file(path, ios::binary);
+    if (!file) {
+        return false;
+    }
+
+    uint32_t header[3];
+    uint64_t count = 0;
+    file.read(reinterpret_cast<char*>(header), sizeof(header));
+    file.read(reinterpret_cast<char*>(&count), sizeof(count));
+    if (!file || header[0] != TOURNAMENT_FILE_MAGIC || header[1] != TOURNAMENT_FILE_VERSION || header[2] != ENGINE_VERSION) {
+        return false;
+    }
+
+    entries.reserve(entries.size() + count);
+    for (uint64_t i = 0; i < count; i++) {
+        uint64_t key;
+        int32_t counts[5];
+        uint64_t totals[3];
+        file.read(reinterpret_cast<char*>(&key), sizeof(key));
+        file.read(reinterpret_cast<char*>(counts), sizeof(counts));
+        file.read(reinterpret_cast<char*>(totals), sizeof(totals));
+        if (!file) {
+            return false;
+        }
+
+        SelfPlayResult& result = entries[key];
+        result.games = counts[0];
+        result.wins[0] = counts[1];
+        result.wins[1] = counts[2];
+        result.unfinished = counts[3];
+        result.firstPlayerWins = counts[4];
+        result.totalTurns = totals[0];
+        result.totalActions = totals[1];
+        result.seed = totals[2];
+    }
+    return true;
+}
+
+bool TournamentCache::save(const string& path) const {
+    ofstream file(path, ios::binary | ios::trunc);
+    if (!file) {
+        return false;
+    }
+
+    const uint32_t header[3] = { TOURNAMENT_FILE_MAGIC, TOURNAMENT_FILE_VERSION, ENGINE_VERSION };
+    const uint64_t count = entries.size();
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    for (const auto& [key, result] : entries) {
+        const int32_t counts[5] = { result.games, result.wins[0], result.wins[1], result.unfinished, result.firstPlayerWins };
+        const uint64_t totals[3] = { result.totalTurns, result.totalActions, result.seed };
+        file.write(reinterpret_cast<const char*>(&key), sizeof(key));
+        file.write(reinterpret_cast<const char*>(counts), sizeof(counts));
+        file.write(reinterpret_cast<const char*>(totals), sizeof(totals));
+    }
+    return (bool)file;
+}
+
+TournamentResult runTournament(const vector<TournamentDeck>& decks, const SelfPlayOptions& options,
+    TournamentCache& cache, const string& cachePath) {
+    const auto start = chrono::steady_clock::now();
+    const int deckCount = (int)decks.size();
+
+    TournamentResult total;
+    total.deckCount = deckCount;
+    total.matches.resize((size_t)deckCount * deckCount);
+
+    // Every match gets its own seed from the decks, so it is dealt the same whatever else is played.
+    // Matches are cached under the seed actually used, a random one never finds the results of another
+    const uint64_t seed = options.seed != 0 ? options.seed : Rng::fromRandomDevice().next64() | 1;
+    SelfPlayOptions keyOptions = options;
+    keyOptions.seed = seed;
+    total.seed = seed;
+
+    vector<pair<int, int>> pending;
+    for (int deck1 = 0; deck1 < deckCount; deck1++) {
+        for (int deck2 = 0; deck2 < deckCount; deck2++) {
+            if (deck1 == deck2) {
+                continue;
+            }
+            const uint64_t key = TournamentCache::matchKey(decks[deck1].hash, decks[deck2].hash, keyOptions);
+            if (cache.find(key, total.matches[(size_t)deck1 * deckCount + deck2])) {
+                total.cached++;
+            }
+            else {
+                pending.emplace_back(deck1, deck2);
+            }
+        }
+    }
+
+    const int hardwareThreads = options.threads > 0 ? options.threads : max(1u, thread::hardware_concurrency());
+    const int threadCount = max(1, min(hardwareThreads, (int)pending.size()));
+    mutex totalLock;
+    atomic<int> nextMatch(0);
+    auto lastSave = chrono::steady_clock::now();
+
+    auto worker = [&]() {
+        for (int m = nextMatch++; m < (int)pending.size(); m = nextMatch++) {
+            const auto [deck1, deck2] = pending[m];
+            SelfPlayOptions matchOptions = options;
+            matchOptions.threads = 1;
+            matchOptions.seed = Rng(seed, mixKey(decks[deck1].hash, decks[deck2].hash)).next64() | 1;
+            const SelfPlayResult result = runSelfPlay(decks[deck1].deck, decks[deck2].deck, matchOptions);
+
+            lock_guard<mutex> guard(totalLock);
+            total.matches[(size_t)deck1 * deckCount + deck2] = result;
+            total.played++;
+            cache.store(TournamentCache::matchKey(decks[deck1].hash, decks[deck2].hash, keyOptions), result);
+            if (!cachePath.empty() && chrono::steady_clock::now() - lastSave > chrono::seconds(TOURNAMENT_SAVE_SECONDS)) {
+                cache.save(cachePath);
+                lastSave = chrono::steady_clock::now();
+            }
+        }
+    };
+
+    vector<thread> threads;
+    for (int t = 1; t < threadCount; t++) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (thread& t : threads) {
+        t.join();
+    }
+
+    if (!cachePath.empty() && total.played > 0) {
+        cache.save(cachePath);
+    }
+    total.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return total;
+}
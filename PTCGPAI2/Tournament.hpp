@@ -0,0 +1,86 @@
+#ifndef TOURNAMENT_HPP
+#define TOURNAMENT_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "SelfPlay.hpp"
+
+using namespace std;
+
+class Deck;
+class CardCollection;
+
+// Version of the rules and the search. Bump it with every change that can change the outcome of a game,
+// so results cached by an older engine are played again
+constexpr uint32_t ENGINE_VERSION = 1;
+
+struct TournamentDeck {
+    string name;
+    shared_ptr<Deck> deck;
+    uint64_t hash = 0;  // deckHash of the deck
+};
+
+// Function to build a deck from card names, returns nullptr if a card is missing or the deck is not valid
+shared_ptr<Deck> buildDeck(const CardCollection& cardCollection, const vector<string>& cardNames);
+
+// Function to split a comma-separated list of card names
+vector<string> splitCardNames(const string& cardNames);
+
+// Fingerprint of the cards of a deck, in any order, and of its energy types, in order. Covers everything the
+// rules read from a deck, so a deck keeps its hash as long as it plays the same, and changes it when a card
+// is swapped, its data changes or the deck generates other energy
+uint64_t deckHash(const Deck& deck);
+
+// Reads a deck list: one deck per line as "name: card,card,...", blank lines and lines starting with # are
+// skipped. Returns false if the file cannot be read or a deck is not valid
+bool loadDeckList(const string& path, const CardCollection& cardCollection, vector<TournamentDeck>& decks);
+
+// Results of finished matches by matchKey, kept on disk between tournaments. Not thread-safe
+class TournamentCache {
+public:
+    // Key of deck1 against deck2 played with these options. options.seed must be the seed the match was
+    // dealt from, not 0
+    static uint64_t matchKey(uint64_t deck1Hash, uint64_t deck2Hash, const SelfPlayOptions& options);
+
+    bool find(uint64_t key, SelfPlayResult& result) const;
+    void store(uint64_t key, const SelfPlayResult& result);
+
+    // Reads or writes the cache, returns false if the file cannot be used. A file written by another
+    // ENGINE_VERSION is not read, every match is played again
+    bool load(const string& path);
+    bool save(const string& path) const;
+
+    size_t size() const { return entries.size(); }
+
+private:
+    unordered_map<uint64_t, SelfPlayResult> entries;
+};
+
+struct TournamentResult {
+    int deckCount = 0;
+    vector<SelfPlayResult> matches;  // [deck1 * deckCount + deck2], options.games games of deck1 against deck2
+    int played = 0;                  // Matches played by this tournament
+    int cached = 0;                  // Matches taken from the cache
+    double seconds = 0.0;
+    uint64_t seed = 0;               // Seed the matches were dealt from, passing it back replays them or finds them cached
+
+    const SelfPlayResult& match(int deck1, int deck2) const { return matches[(size_t)deck1 * deckCount + deck2]; }
+    // Games of deck a against deck b in both seats, and the ones deck a won
+    int games(int a, int b) const { return match(a, b).games + match(b, a).games; }
+    int wins(int a, int b) const { return match(a, b).wins[0] + match(b, a).wins[1]; }
+    double winRate(int a, int b) const { return games(a, b) > 0 ? (double)wins(a, b) / games(a, b) : 0.0; }
+};
+
+// Plays every deck against every other deck in both seats, options.games games per match. Matches are shared
+// out to options.threads threads and each is played on one thread, so with a node budget a result does not
+// depend on the threads or on which other matches were cached. Without a seed a random one is drawn, so only
+// a run given an earlier result's seed can reuse its matches. Matches found in the cache are not played,
+// new results are stored in it and, if cachePath is not empty, saved every few minutes and at the end
+TournamentResult runTournament(const vector<TournamentDeck>& decks, const SelfPlayOptions& options,
+    TournamentCache& cache, const string& cachePath = "");
+
+#endif // TOURNAMENT_HPP
@@ -0,0 +1,89 @@
+#include "TranspositionTable.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+constexpr uint64_t COMPLETE_BIT = 1ull << 63;
+
+constexpr int GENERATION_BITS = 3;
+
+// Packs a result into one word: value in bits 0-31, best move in 32-47, depth in 48-53, bound in 54-55,
+// horizon in 56-59, generation in 60-62 and the complete flag in bit 63
+static uint64_t packEntry(int value, int depth, BoundType bound, const Action& bestMove, bool complete, int horizon, uint8_t generation) {
+    uint16_t move;
+    memcpy(&move, &bestMove, sizeof(move));
+    return (uint64_t)(uint32_t)value | (uint64_t)move << 32 | (uint64_t)min(depth, MAX_TT_DEPTH) << 48 | (uint64_t)bound << 54
+        | (uint64_t)(horizon % MAX_TT_HORIZON) << 56 | (uint64_t)generation << 60 | (complete ? COMPLETE_BIT : 0);
+}
+
+static BoundType unpackBound(uint64_t data) {
+    return (BoundType)((data >> 54) & 0x3);
+}
+
+static uint8_t unpackGeneration(uint64_t data) {
+    return (uint8_t)((data >> 60) & ((1 << GENERATION_BITS) - 1));
+}
+
+static int unpackDepth(uint64_t data) {
+    return (int)((data >> 48) & MAX_TT_DEPTH);
+}
+
+TranspositionTable::TranspositionTable(size_t sizeInMB) {
+    resize(sizeInMB);
+}
+
+void TranspositionTable::resize(size_t sizeInMB) {
+    count = 1;
+    while (count * 2 * sizeof(TTSlot) <= sizeInMB * 1024 * 1024) {
+        count *= 2;
+    }
+    slots.reset(new TTSlot[count]);
+    mask = count - 1;
+}
+
+void TranspositionTable::clear() {
+    for (size_t i = 0; i < count; i++) {
+        slots[i].check.store(0, memory_order_relaxed);
+        slots[i].data.store(0, memory_order_relaxed);
+    }
+    generation = 0;
+}
+
+void TranspositionTable::newSearch() {
+    generation = (generation + 1) & ((1 << GENERATION_BITS) - 1);
+}
+
+bool TranspositionTable::probe(uint64_t key, TTEntry& entry) const {
+    const TTSlot& slot = slots[key & mask];
+    const uint64_t data = slot.data.load(memory_order_relaxed);
+    const uint64_t check = slot.check.load(memory_order_relaxed);
+    if (unpackBound(data) == BoundType::NONE || (check ^ data) != key) {
+        return false;
+    }
+
+    uint16_t move = (uint16_t)(data >> 32);
+    entry.key = key;
+    entry.value = (int32_t)(uint32_t)data;
+    memcpy(&entry.bestMove, &move, sizeof(move));
+    entry.depth = (uint8_t)unpackDepth(data);
+    entry.bound = unpackBound(data);
+    entry.complete = (data & COMPLETE_BIT) != 0;
+    entry.horizon = (uint8_t)((data >> 56) & (MAX_TT_HORIZON - 1));
+    return true;
+}
+
+void TranspositionTable::store(uint64_t key, int value, int depth, BoundType bound, const Action& bestMove, bool complete, int horizon) {
+    TTSlot& slot = slots[key & mask];
+
+    // Depth-preferred replacement within a search, but results for the same position are always refreshed
+    // and results of earlier searches give way to the current one
+    const uint64_t oldData = slot.data.load(memory_order_relaxed);
+    const uint64_t oldKey = slot.check.load(memory_order_relaxed) ^ oldData;
+    if (unpackBound(oldData) != BoundType::NONE && oldKey != key && unpackGeneration(oldData) == generation && unpackDepth(oldData) > depth) {
+        return;
+    }
+
+    const uint64_t data = packEntry(value, depth, bound, bestMove, complete, horizon, generation);
+    slot.data.store(data, memory_order_relaxed);
+    slot.check.store(key ^ data, memory_order_relaxed);
+}
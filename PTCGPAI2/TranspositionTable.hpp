@@ -0,0 +1,72 @@
+#ifndef TRANSPOSITIONTABLE_HPP
+#define TRANSPOSITIONTABLE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "Action.hpp"
+
+using namespace std;
+
+// How a stored value relates to the true value of the position
+enum class BoundType : uint8_t {
+    NONE,   // Empty entry
+    EXACT,  // The value is exact
+    LOWER,  // The search failed high, the true value is at least the stored value
+    UPPER   // The search failed low, the true value is at most the stored value
+};
+
+// One search result as returned by probe
+struct TTEntry {
+    uint64_t key = 0;          // Full Zobrist key, guards against index collisions
+    int32_t value = 0;
+    Action bestMove = Action(ActionType::ROOT);
+    uint8_t depth = 0;         // Remaining depth the value was searched to
+    BoundType bound = BoundType::NONE;
+    bool complete = false;     // No leaf below was cut off by depth, so deeper searches give the same value
+    uint8_t horizon = 0;       // Turns left below the position modulo MAX_TT_HORIZON, 0 if the caller keys by turn
+};
+
+// Horizons an entry can tell apart, searches with more turns ahead put the rest of the horizon into the key
+constexpr int MAX_TT_HORIZON = 16;
+
+// Stored form of an entry. The result is packed into one word and the key is stored XORed with it,
+// so an entry torn by two threads writing at once fails the key check and reads as empty
+struct TTSlot {
+    atomic<uint64_t> check{ 0 };  // key ^ data
+    atomic<uint64_t> data{ 0 };   // value, best move, depth, bound, horizon, generation and complete flag
+};
+
+constexpr int MAX_TT_DEPTH = 63;
+
+// Fixed-size hash table of search results indexed by the position's Zobrist key.
+// Lock-free, so any number of search threads can share one table
+class TranspositionTable {
+public:
+    explicit TranspositionTable(size_t sizeInMB = 16);
+
+    // Reallocates the table, rounding the entry count down to a power of two. Clears all entries
+    void resize(size_t sizeInMB);
+    void clear();
+
+    // Starts a new search. Entries of earlier searches can still be probed, but any new result may replace them
+    void newSearch();
+
+    // Looks up a position, returns false if it has no entry
+    bool probe(uint64_t key, TTEntry& entry) const;
+
+    // Stores a result, keeping the deeper one when a different position occupies the slot. Depths above
+    // MAX_TT_DEPTH are stored as MAX_TT_DEPTH, so they only answer probes up to that depth
+    void store(uint64_t key, int value, int depth, BoundType bound, const Action& bestMove, bool complete = false, int horizon = 0);
+
+    size_t size() const { return count; }
+
+private:
+    unique_ptr<TTSlot[]> slots;
+    size_t count = 0;
+    size_t mask = 0;
+    uint8_t generation = 0;
+};
+
+#endif // TRANSPOSITIONTABLE_HPP
@@ -0,0 +1,90 @@
+#include "Zobrist.hpp"
+
+// splitmix64 with a fixed seed, so keys are identical across runs and can be persisted
+static uint64_t nextKey(uint64_t& seed) {
+    uint64_t z = (seed += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+void Zobrist::build(size_t cardCount, int maxHP) {
+    uint64_t seed = 0x5054434750414932ull;
+
+    Zobrist::cardCount = cardCount;
+    hpCount = maxHP + 1;
+
+    cardKeys.resize(2 * NUM_POKEMON_SLOTS * cardCount);
+    for (uint64_t& key : cardKeys) {
+        key = nextKey(seed);
+    }
+
+    hpKeys.resize(2 * NUM_POKEMON_SLOTS * hpCount);
+    for (uint64_t& key : hpKeys) {
+        key = nextKey(seed);
+    }
+
+    // A count of zero contributes nothing, so attaching the first energy is a single XOR
+    energyKeys.resize(2 * NUM_POKEMON_SLOTS * NUM_ENERGY_TYPES * (MAX_ENERGY_PER_TYPE + 1));
+    for (size_t i = 0; i < energyKeys.size(); i++) {
+        energyKeys[i] = i % (MAX_ENERGY_PER_TYPE + 1) == 0 ? 0 : nextKey(seed);
+    }
+
+    handKeys.resize(2 * cardCount * MAX_HAND_SIZE);
+    for (uint64_t& key : handKeys) {
+        key = nextKey(seed);
+    }
+
+    for (int player = 0; player < 2; player++) {
+        for (uint64_t& key : availableEnergyKeys[player]) {
+            key = nextKey(seed);
+        }
+        for (uint64_t& key : pointsKeys[player]) {
+            key = nextKey(seed);
+        }
+    }
+    sideKey = nextKey(seed);
+    for (uint64_t& key : outcomeKeys) {
+        key = nextKey(seed);
+    }
+    for (int from = 1; from <= NO_CANONICAL_PLAY; from++) {
+        canonicalPlayKeys[from] = nextKey(seed);
+    }
+}
+
+uint64_t Zobrist::pokemonKey(int player, int slot, const ActivePokemon& pokemon) {
+    if (pokemon.isEmpty()) {
+        return 0;
+    }
+
+    uint64_t key = cardKey(player, slot, pokemon.card) ^ hpKey(player, slot, pokemon.currentHP);
+    for (int t = 0; t < NUM_ENERGY_TYPES; t++) {
+        key ^= energyKey(player, slot, t, energyCount(pokemon.currentEnergy, ENERGY_TYPES[t]));
+    }
+    return key;
+}
+
+uint64_t Zobrist::computeKey(const GameState& state) {
+    uint64_t key = sideToMoveKey(state.currentPlayer) ^ outcomeKey(state.gameOver, state.winner);
+
+    for (int player = 0; player < 2; player++) {
+        key ^= pointsKey(player, state.playerPoints[player]);
+        key ^= availableEnergyKey(player, state.playerAvailableEnergy[player]);
+
+        key ^= pokemonKey(player, ACTIVE_SLOT, state.playerActiveSpots[player]);
+        for (int b = 0; b < state.playerBenchSize[player]; b++) {
+            key ^= pokemonKey(player, b + 1, state.playerBenchSpots[player][b]);
+        }
+
+        // Number each copy of a card in the order they appear in the hand
+        for (int i = 0; i < state.playerHandSize[player]; i++) {
+            CardID card = state.playerHands[player][i];
+            int copy = 0;
+            for (int j = 0; j < i; j++) {
+                copy += state.playerHands[player][j] == card;
+            }
+            key ^= handKey(player, card, copy);
+        }
+    }
+    return key;
+}
@@ -0,0 +1,64 @@
+#ifndef ZOBRIST_HPP
+#define ZOBRIST_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "GameState.hpp"
+
+using namespace std;
+
+constexpr int MAX_ZOBRIST_POINTS = 8;  // Points beyond this share a key, games end at 3
+
+// Random keys for every feature of a position. A position's key is the XOR of the keys of its
+// features, so Game can update it incrementally by XORing features out and back in.
+// The draw pile is not part of the key, it is hidden and only drawn from for the opening hands.
+class Zobrist {
+public:
+    // Generates the tables for the interned cards, called by CardTable::build
+    static void build(size_t cardCount, int maxHP);
+
+    // Full contribution of a Pokemon spot: card, HP and every attached energy. Empty spots are 0
+    static uint64_t pokemonKey(int player, int slot, const ActivePokemon& pokemon);
+    static uint64_t cardKey(int player, int slot, CardID card) { return cardKeys[(player * NUM_POKEMON_SLOTS + slot) * cardCount + card]; }
+    static uint64_t hpKey(int player, int slot, int hp) { return hpKeys[(player * NUM_POKEMON_SLOTS + slot) * hpCount + clampHP(hp)]; }
+    static uint64_t energyKey(int player, int slot, int typeIndex, int count) {
+        return energyKeys[((player * NUM_POKEMON_SLOTS + slot) * NUM_ENERGY_TYPES + typeIndex) * (MAX_ENERGY_PER_TYPE + 1) + count];
+    }
+
+    // The k-th copy of a card in hand has its own key, so duplicates do not cancel out
+    static uint64_t handKey(int player, CardID card, int copy) { return handKeys[(player * cardCount + card) * MAX_HAND_SIZE + copy]; }
+
+    // Energy waiting to be attached, 'X' (none) has key 0
+    static uint64_t availableEnergyKey(int player, char energy) {
+        int index = energyTypeIndex(energy);
+        return index < 0 ? 0 : availableEnergyKeys[player][index];
+    }
+    static uint64_t pointsKey(int player, int points) { return pointsKeys[player][points < MAX_ZOBRIST_POINTS ? points : MAX_ZOBRIST_POINTS - 1]; }
+    static uint64_t sideToMoveKey(int player) { return player == 1 ? sideKey : 0; }
+    static uint64_t outcomeKey(bool gameOver, int winner) { return gameOver ? outcomeKeys[winner + 1] : 0; }
+    // Canonical move order within the turn, 0 (no restriction) has key 0. Not part of the position's key:
+    // the same board is the same position whatever order it was reached in, only searches that generate
+    // canonical moves add it to their keys
+    static uint64_t canonicalPlayKey(int from) { return canonicalPlayKeys[from]; }
+
+    // Recomputes the key of a position from scratch, without canonicalPlayKey
+    static uint64_t computeKey(const GameState& state);
+
+private:
+    static int clampHP(int hp) { return hp < 0 ? 0 : (hp < hpCount ? hp : hpCount - 1); }
+
+    static inline size_t cardCount = 0;
+    static inline int hpCount = 0;
+    static inline vector<uint64_t> cardKeys;
+    static inline vector<uint64_t> hpKeys;
+    static inline vector<uint64_t> energyKeys;
+    static inline vector<uint64_t> handKeys;
+    static inline uint64_t availableEnergyKeys[2][NUM_ENERGY_TYPES] = {};
+    static inline uint64_t pointsKeys[2][MAX_ZOBRIST_POINTS] = {};
+    static inline uint64_t sideKey = 0;
+    static inline uint64_t outcomeKeys[3] = {};
+    static inline uint64_t canonicalPlayKeys[NO_CANONICAL_PLAY + 1] = {};
+};
+
+#endif // ZOBRIST_HPP
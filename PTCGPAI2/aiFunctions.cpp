@@ -3,74 +3,866 @@
 #include "Action.hpp"
 #include "Game.hpp"
 #include "utilities.hpp"
+#include "TranspositionTable.hpp"
+#include "Evaluation.hpp"
+#include "Endgame.hpp"
+#include "Zobrist.hpp"
 
 #include <memory>
+#include <algorithm>
+#include <climits>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <vector>
 
-int evaluateGameState(const shared_ptr<GameState>& state, int currentPlayer) {
-    int opponent = 1 - currentPlayer;
-
-    int score = 0;
-
-    // Give points for player's progress
-    score += state->playerPoints[currentPlayer] * 100;
-    score -= state->playerPoints[opponent] * 100;  // Opponent gaining points is bad
-
-    // Reward having benched Pokmon (more options later)
-    score += state->playerBenchSpots[currentPlayer].size() * 10;
-    score -= state->playerBenchSpots[opponent].size() * 10;
+int evaluateGameState(const GameState& state, int currentPlayer) {
+    // Game keeps the evaluation up to date as actions are made and unmade
+    return Evaluation::scoreFor(state, currentPlayer);
+}
 
-    // Reward damage dealt (assuming 'damageDealt' holds total damage by player)
-    if (state->playerActiveSpots[currentPlayer] != nullptr) {
-        score -= state->playerActiveSpots[currentPlayer]->pokemonCard->hp - state->playerActiveSpots[currentPlayer]->currentHP;
-    }
-    else {
-        printError("ERROR NO ACTIVE POKEKMON");
-        displayGameState(state);
-    }
+// Keeps maximizing and minimizing results for the same position apart in the table
+constexpr uint64_t MINIMIZING_KEY = 0x9E3779B97F4A7C15ull;
 
-    if (state->playerActiveSpots[opponent] != nullptr) {
-        score += state->playerActiveSpots[opponent]->pokemonCard->hp - state->playerActiveSpots[opponent]->currentHP;
-    }
-    else {
-        printError("ERROR NO ACTIVE POKEKMON");
-        displayGameState(state);
-    }
+// The searches stop after a number of turns, so the same position only has the same subtree when it is
+// reached in the same turn. The turn is part of the key, the remaining depth is not: it is stored with
+// the entry, and a result searched at least as deep as the probe answers it
+static uint64_t searchKey(const GameState& state, int turn) {
+    return state.zobristKey ^ ((uint64_t)turn * 0x9FB21C651E98DF25ull);
+}
 
-    return score;
+// Turn of a child in the action tree, counted from the root
+static int childTurn(const ActionNode& child, int turn) {
+    return endsTurn(child.action) ? turn + 1 : turn;
 }
 
-pair<int, Action> minimax(shared_ptr<ActionNode> node, int depth, bool maximizingPlayer, int currentPlayer) {
-    if (depth == 0 || node->children.empty()) {
+static pair<int, Action> minimaxSearch(const ActionNode* node, int depth, int turn, bool maximizingPlayer, int currentPlayer, TranspositionTable& table) {
+    if (depth == 0 || node->childCount == 0) {
         int evaluation = evaluateGameState(node->state, currentPlayer);
         return { evaluation, node->action };
     }
+
+    // Move orders that commute reach the same position, only the first one is searched
+    const uint64_t key = searchKey(node->state, turn) ^ (maximizingPlayer ? 0 : MINIMIZING_KEY);
+    TTEntry entry;
+    if (table.probe(key, entry) && entry.depth >= depth && entry.bound == BoundType::EXACT) {
+        return { entry.value, entry.bestMove };
+    }
+
     if (maximizingPlayer) {
         int maxEval = INT_MIN;
-        Action bestAction = node->children[0]->action;
-        for (auto& child : node->children) {
-            int eval = minimax(child, depth - 1, true, currentPlayer).first;
+        Action bestAction = node->firstChild[0].action;
+        for (const ActionNode& child : node->children()) {
+            // Whoever moves next in the child decides whether it is maximized or minimized
+            int eval = minimaxSearch(&child, depth - 1, childTurn(child, turn), child.state.currentPlayer == currentPlayer, currentPlayer, table).first;
             if (eval > maxEval) {
                 maxEval = eval;
-                bestAction = child->action;
+                bestAction = child.action;
             }
         }
+        table.store(key, maxEval, depth, BoundType::EXACT, bestAction);
         return { maxEval, bestAction };
     }
     else { // Opponent's turn (minimizing)
         int minEval = INT_MAX;
-        Action worstAction = node->children[0]->action;
+        Action worstAction = node->firstChild[0].action;
 
-        for (auto& child : node->children) {
-            int eval = minimax(child, depth - 1, false, currentPlayer).first;
+        for (const ActionNode& child : node->children()) {
+            int eval = minimaxSearch(&child, depth - 1, childTurn(child, turn), child.state.currentPlayer == currentPlayer, currentPlayer, table).first;
             if (eval < minEval) {
                 minEval = eval;
-                worstAction = child->action;
+                worstAction = child.action;
             }
         }
+        table.store(key, minEval, depth, BoundType::EXACT, worstAction);
         return { minEval, worstAction };
     }
 }
 
-Action findBestAction(shared_ptr<ActionNode> rootNode, int depth, int currentPlayer) {
-    return minimax(rootNode, depth, true, currentPlayer).second;
+pair<int, Action> minimax(const ActionNode* node, int depth, bool maximizingPlayer, int currentPlayer, TranspositionTable& table) {
+    return minimaxSearch(node, depth, 0, maximizingPlayer, currentPlayer, table);
+}
+
+constexpr int MAX_SEARCH_PLY = 64;
+constexpr int HISTORY_SIZE = 6 * 32 * 8;  // Every ActionType, target and attack combination
+
+// Move ordering state gathered during one search
+struct SearchHeuristics {
+    Action killers[MAX_SEARCH_PLY][2];  // Last two moves that caused a cutoff at each ply
+    int history[HISTORY_SIZE] = {};     // Cutoffs per move, weighted by the depth they happened at
+
+    SearchHeuristics() {
+        for (auto& killer : killers) {
+            killer[0] = killer[1] = Action(ActionType::ROOT);
+        }
+    }
+};
+
+static int historyIndex(const Action& action) {
+    return ((int)action.type * 32 + action.target) * 8 + action.attack;
+}
+
+// Checks whether an attack knocks out the defending Pokemon
+static bool knocksOut(const GameState& state, const Action& action) {
+    const ActivePokemon& attacker = state.playerActiveSpots[state.currentPlayer];
+    const ActivePokemon& defender = state.playerActiveSpots[1 - state.currentPlayer];
+    if (attacker.isEmpty() || defender.isEmpty()) {
+        return false;
+    }
+    return CardTable::getStats(attacker.card).attacks[action.attack].damage >= defender.currentHP;
+}
+
+// Function to score a move for ordering: table move, knockouts, attacks, energy, plays and END_TURN last.
+// Killers and history order the moves within each group
+static int scoreMove(const GameState& state, const Action& action, const Action& tableMove, int ply, const SearchHeuristics& heuristics) {
+    if (action == tableMove) {
+        return INT_MAX;
+    }
+
+    int score = 0;
+    switch (action.type) {
+    case ActionType::ATTACK: score = knocksOut(state, action) ? 5000000 : 4000000; break;
+    case ActionType::ENERGY: score = 3000000; break;
+    case ActionType::PLAY:
+    case ActionType::BENCH:  score = 2000000; break;
+    default: break;
+    }
+
+    if (ply < MAX_SEARCH_PLY) {
+        if (action == heuristics.killers[ply][0]) {
+            score += 800000;
+        }
+        else if (action == heuristics.killers[ply][1]) {
+            score += 700000;
+        }
+    }
+    return score + min(heuristics.history[historyIndex(action)], 600000);
+}
+
+// Function to sort the moves best first, fills order with indices into moves
+static void orderMoves(const GameState& state, const Action* moves, int count, const Action& tableMove, int ply,
+    const SearchHeuristics& heuristics, int* order) {
+    pair<int, int> scored[MAX_MOVES];
+    for (int i = 0; i < count; i++) {
+        scored[i] = { scoreMove(state, moves[i], tableMove, ply, heuristics), i };
+    }
+    stable_sort(scored, scored + count, [](const pair<int, int>& a, const pair<int, int>& b) { return a.first > b.first; });
+    for (int i = 0; i < count; i++) {
+        order[i] = scored[i].second;
+    }
+}
+
+// Remember the refutation for sibling positions, attacks are already ordered first
+static void recordCutoff(SearchHeuristics& heuristics, const Action& action, int ply, int depth) {
+    if (action.type != ActionType::ATTACK && ply < MAX_SEARCH_PLY && heuristics.killers[ply][0] != action) {
+        heuristics.killers[ply][1] = heuristics.killers[ply][0];
+        heuristics.killers[ply][0] = action;
+    }
+    heuristics.history[historyIndex(action)] += depth * depth;
+}
+
+// Reuse what an earlier visit of this position proved about its value, returns true if that settles it
+// An entry of another horizon still orders the moves, but its value looked a different number of turns ahead
+static bool probeTable(const TranspositionTable& table, uint64_t key, int depth, int horizon, int& alpha, int& beta, Action& tableMove,
+    int& value, bool& complete, int* entryDepth = nullptr) {
+    TTEntry entry;
+    if (!table.probe(key, entry)) {
+        return false;
+    }
+    tableMove = entry.bestMove;
+    if (entry.horizon != horizon % MAX_TT_HORIZON) {
+        return false;
+    }
+    complete = entry.complete;
+    if (entryDepth != nullptr) {
+        *entryDepth = entry.depth;
+    }
+    if (entry.depth < depth) {
+        return false;
+    }
+
+    if (entry.bound == BoundType::EXACT) {
+        value = entry.value;
+        return true;
+    }
+    if (entry.bound == BoundType::LOWER) {
+        alpha = max(alpha, entry.value);
+    }
+    else if (entry.bound == BoundType::UPPER) {
+        beta = min(beta, entry.value);
+    }
+    value = entry.value;
+    return alpha >= beta;
+}
+
+static BoundType boundFor(int value, int alphaOriginal, int betaOriginal) {
+    if (value <= alphaOriginal) {
+        return BoundType::UPPER;
+    }
+    if (value >= betaOriginal) {
+        return BoundType::LOWER;
+    }
+    return BoundType::EXACT;
+}
+
+static int alphaBetaSearch(const ActionNode* node, int depth, int ply, int turn, int alpha, int beta, int currentPlayer,
+    TranspositionTable& table, SearchHeuristics& heuristics, Action& bestAction) {
+    bestAction = node->action;
+    if (depth == 0 || node->childCount == 0) {
+        return evaluateGameState(node->state, currentPlayer);
+    }
+
+    const uint64_t key = searchKey(node->state, turn);
+    const int alphaOriginal = alpha;
+    const int betaOriginal = beta;
+    Action tableMove(ActionType::ROOT);
+    int tableValue;
+    bool complete;
+    if (probeTable(table, key, depth, 0, alpha, beta, tableMove, tableValue, complete)) {
+        bestAction = tableMove;
+        return tableValue;
+    }
+
+    // Order the children so the likely best move is searched first
+    Action moves[MAX_MOVES] = {};
+    int order[MAX_MOVES];
+    const int childCount = min<int>(node->childCount, MAX_MOVES);
+    for (int i = 0; i < childCount; i++) {
+        moves[i] = node->firstChild[i].action;
+    }
+    orderMoves(node->state, moves, childCount, tableMove, ply, heuristics, order);
+
+    const bool maximizingPlayer = node->state.currentPlayer == currentPlayer;
+    int bestEval = maximizingPlayer ? INT_MIN : INT_MAX;
+    bestAction = moves[order[0]];
+
+    for (int i = 0; i < childCount; i++) {
+        const ActionNode* child = &node->firstChild[order[i]];
+        Action childBest;
+        int eval = alphaBetaSearch(child, depth - 1, ply + 1, childTurn(*child, turn), alpha, beta, currentPlayer, table, heuristics, childBest);
+
+        if (maximizingPlayer ? eval > bestEval : eval < bestEval) {
+            bestEval = eval;
+            bestAction = child->action;
+        }
+        if (maximizingPlayer) {
+            alpha = max(alpha, eval);
+        }
+        else {
+            beta = min(beta, eval);
+        }
+
+        if (alpha >= beta) {
+            recordCutoff(heuristics, child->action, ply, depth);
+            break;
+        }
+    }
+
+    table.store(key, bestEval, depth, boundFor(bestEval, alphaOriginal, betaOriginal), bestAction);
+    return bestEval;
+}
+
+pair<int, Action> alphaBeta(const ActionNode* node, int depth, int alpha, int beta, int currentPlayer, TranspositionTable& table) {
+    SearchHeuristics heuristics;
+    Action bestAction;
+    int eval = alphaBetaSearch(node, depth, 0, 0, alpha, beta, currentPlayer, table, heuristics, bestAction);
+    return { eval, bestAction };
+}
+
+// Everything one tree-free search shares across its nodes
+struct SearchContext {
+    TranspositionTable& table;
+    SearchHeuristics heuristics;
+    int currentPlayer;
+    int maxTurns;
+    Action rootMove = Action(ActionType::ROOT);  // Best move of the previous iteration, searched first
+
+    // Budgets, checked every NODE_CHECK_INTERVAL nodes
+    uint64_t nodes = 0;
+    uint64_t maxNodes = 0;
+    bool hasDeadline = false;
+    chrono::steady_clock::time_point deadline;
+    const atomic<bool>* stop = nullptr;
+    atomic<uint64_t>* sharedNodes = nullptr;  // Counter of all searches sharing maxNodes
+    bool aborted = false;
+
+    bool depthLimited = false;  // Set when a leaf was cut off by depth rather than by turns or the game ending
+    int rootTableDepth = 0;     // Depth of the table entry the root value was taken from, 0 if it was searched
+    int evaluationBound;        // No evaluation is outside [-evaluationBound, evaluationBound]
+    bool canonicalTurns = true; // Generate moves with getCanonicalActions
+
+    SearchContext(TranspositionTable& table, int currentPlayer, int maxTurns)
+        : table(table), currentPlayer(currentPlayer), maxTurns(maxTurns), evaluationBound(Evaluation::bound()) {}
+};
+
+constexpr uint64_t NODE_CHECK_INTERVAL = 1024;
+
+// Function to check the budgets, once one runs out every search still running unwinds
+static bool shouldAbort(SearchContext& context) {
+    if (context.aborted) {
+        return true;
+    }
+    if (++context.nodes % NODE_CHECK_INTERVAL != 0) {
+        return false;
+    }
+    const uint64_t budgetNodes = context.sharedNodes != nullptr ? (*context.sharedNodes += NODE_CHECK_INTERVAL) : context.nodes;
+    if ((context.maxNodes > 0 && budgetNodes >= context.maxNodes)
+        || (context.stop != nullptr && context.stop->load(memory_order_relaxed))
+        || (context.hasDeadline && chrono::steady_clock::now() >= context.deadline)) {
+        context.aborted = true;
+    }
+    return context.aborted;
+}
+
+static MoveList generateMoves(Game& game, const SearchContext& context) {
+    return context.canonicalTurns ? getCanonicalActions(game) : getLegalActions(game);
+}
+
+// Values are scored for the root player, so their results for the same position are kept apart
+constexpr uint64_t SECOND_PLAYER_KEY = 0xC2B2AE3D27D4EB4Full;
+
+// Turns left to search below a position, the horizon its value depends on
+static int horizonOf(int turn, const SearchContext& context) {
+    return context.maxTurns - turn;
+}
+
+// Key of a position in the tree-free search. The horizon is stored in the entry rather than in the key, so
+// a position keeps its slot when a later search reaches it with more turns left. A search from the same
+// turn finds the values of earlier ones; after the opponent's reply the next root is a grandchild of the
+// last one, and its subtree gets the best moves found for it, which order the first iterations. Canonical
+// turns offer fewer moves once energy was attached, so there the key tells those positions apart
+static uint64_t nodeKey(const GameState& state, int turn, const SearchContext& context) {
+    return searchKey(state, horizonOf(turn, context) / MAX_TT_HORIZON) ^ (context.currentPlayer == 1 ? SECOND_PLAYER_KEY : 0)
+        ^ (context.canonicalTurns ? Zobrist::canonicalPlayKey(state.canonicalPlayFrom) : 0);
+}
+
+static int64_t floorDiv(int64_t a, int64_t b) {
+    return a / b - (a % b != 0 && (a < 0) != (b < 0));
+}
+
+// Chance nodes average their outcomes, rounded to the nearest integer with halves rounded up
+static int roundedAverage(int64_t sum, int64_t count) {
+    return (int)floorDiv(2 * sum + count, 2 * count);
+}
+
+static int clampToInt(int64_t value) {
+    return (int)max<int64_t>(INT_MIN, min<int64_t>(INT_MAX, value));
+}
+
+static int depthFirstSearch(Game& game, int depth, int ply, int turn, int alpha, int beta, SearchContext& context, Action& bestAction);
+static int searchMove(Game& game, const Action& action, int depth, int ply, int turn, int alpha, int beta, SearchContext& context);
+
+// Searches only the first move the position would try. Its value bounds the position from the side of
+// the player to move: from below for the maximizing player, from above for the minimizing one.
+// Returns false if the position is a leaf, value is then its exact value
+static bool probeFirstMove(Game& game, int depth, int ply, int turn, int alpha, int beta, SearchContext& context, int& value) {
+    const GameState& state = game.getGameState();
+    MoveList moves;
+    if (depth > 0 && turn < context.maxTurns && !state.gameOver) {
+        moves = generateMoves(game, context);
+    }
+    if (moves.empty()) {
+        Action bestAction;
+        value = depthFirstSearch(game, depth, ply, turn, alpha, beta, context, bestAction);
+        return false;
+    }
+
+    Action tableMove = Action(ActionType::ROOT);
+    TTEntry entry;
+    if (context.table.probe(nodeKey(state, turn, context), entry)) {
+        tableMove = entry.bestMove;
+    }
+    int order[MAX_MOVES];
+    orderMoves(state, moves.begin(), (int)moves.size(), tableMove, ply, context.heuristics, order);
+
+    const Action& first = moves[order[0]];
+    const int nextTurn = endsTurn(first) ? turn + 1 : turn;
+    value = searchMove(game, first, depth - 1, ply + 1, nextTurn, alpha, beta, context);
+    return true;
+}
+
+// Expected value over the energy types the next player can get, which are equally likely.
+// Star2 first probes one move per outcome to bound it from the side of the player to move there,
+// then Star1 searches the outcomes in turn and cuts off once the bounds of the outcomes left
+// cannot bring the average back inside the window
+static int chanceNode(Game& game, const Action& action, int outcomes, int depth, int ply, int turn, int alpha, int beta, SearchContext& context) {
+    const int64_t count = outcomes;
+    const int64_t bound = context.evaluationBound;
+
+    // Energy cannot matter once the game is over
+    UndoRecord undo;
+    game.setEnergyOutcome(0);
+    game.makeAction(action, undo);
+    const bool maximizingChild = game.getGameState().currentPlayer == context.currentPlayer;
+    if (game.getGameState().gameOver) {
+        Action childBest;
+        int eval = depthFirstSearch(game, depth, ply, turn, alpha, beta, context, childBest);
+        game.unmakeAction(undo);
+        return eval;
+    }
+    game.unmakeAction(undo);
+
+    int64_t lower[MAX_DECK_ENERGY_TYPES];
+    int64_t upper[MAX_DECK_ENERGY_TYPES];
+    for (int i = 0; i < outcomes; i++) {
+        lower[i] = -bound;
+        upper[i] = bound;
+    }
+
+    // Star2: a maximizing player can only fail the node high and a minimizing one only low
+    const bool probeHigh = maximizingChild && beta != INT_MAX;
+    const bool probeLow = !maximizingChild && alpha != INT_MIN;
+    if (depth > 0 && (probeHigh || probeLow)) {
+        int64_t known = 0;  // Sum of the bounds probed so far
+        for (int i = 0; i < outcomes; i++) {
+            // Value this outcome needs for the node to cut off even if the outcomes after it reach the evaluation bound
+            const int64_t rest = (outcomes - 1 - i) * (probeHigh ? bound : -bound);
+            const int64_t threshold = (probeHigh ? (int64_t)beta : (int64_t)alpha) * count - known - rest;
+
+            if (probeHigh ? threshold <= bound : threshold >= -bound) {
+                int value;
+                game.setEnergyOutcome(i);
+                game.makeAction(action, undo);
+                const bool searched = probeHigh
+                    ? probeFirstMove(game, depth, ply, turn, clampToInt(threshold - 1), clampToInt(threshold), context, value)
+                    : probeFirstMove(game, depth, ply, turn, clampToInt(threshold), clampToInt(threshold + 1), context, value);
+                game.unmakeAction(undo);
+                if (context.aborted) {
+                    return 0;
+                }
+
+                if (!searched) {
+                    lower[i] = upper[i] = value;
+                }
+                else if (probeHigh && value >= threshold) {
+                    lower[i] = value;
+                }
+                else if (probeLow && value <= threshold) {
+                    upper[i] = value;
+                }
+            }
+            known += probeHigh ? lower[i] : upper[i];
+        }
+
+        if (probeHigh ? known >= (int64_t)beta * count : known <= (int64_t)alpha * count) {
+            return roundedAverage(known, count);
+        }
+    }
+
+    // Star1
+    int64_t sum = 0;  // Sum of the outcomes searched so far
+    for (int i = 0; i < outcomes; i++) {
+        int64_t restLower = 0;
+        int64_t restUpper = 0;
+        for (int j = i + 1; j < outcomes; j++) {
+            restLower += lower[j];
+            restUpper += upper[j];
+        }
+        const int childAlpha = alpha == INT_MIN ? INT_MIN : clampToInt(alpha * count - sum - restUpper);
+        const int childBeta = beta == INT_MAX ? INT_MAX : clampToInt(beta * count - sum - restLower);
+
+        game.setEnergyOutcome(i);
+        game.makeAction(action, undo);
+        Action childBest;
+        int eval = depthFirstSearch(game, depth, ply, turn, childAlpha, childBeta, context, childBest);
+        game.unmakeAction(undo);
+        if (context.aborted) {
+            return 0;
+        }
+
+        if (eval <= childAlpha) {
+            return roundedAverage(sum + eval + restUpper, count);
+        }
+        if (eval >= childBeta) {
+            return roundedAverage(sum + eval + restLower, count);
+        }
+        sum += eval;
+    }
+    return roundedAverage(sum, count);
+}
+
+// Function to search the position after one move
+static int searchMove(Game& game, const Action& action, int depth, int ply, int turn, int alpha, int beta, SearchContext& context) {
+    const int outcomes = game.getGameState().playerEnergyTypeCount[1 - game.getGameState().currentPlayer];
+    // Moves that end the turn generate the next player's energy, so they lead to a chance node
+    if (endsTurn(action) && outcomes > 0) {
+        return chanceNode(game, action, outcomes, depth, ply, turn, alpha, beta, context);
+    }
+
+    UndoRecord undo;
+    game.makeAction(action, undo);
+    Action childBest;
+    int eval = depthFirstSearch(game, depth, ply, turn, alpha, beta, context, childBest);
+    game.unmakeAction(undo);
+    return eval;
+}
+
+// Same search as alphaBetaSearch, but the children are made and unmade on the game instead of read
+// from a prebuilt tree. Expands the nodes buildActionTree would: forced actions first, and no children
+// once the game is over or maxTurns turns have ended, with canonical turns unless turned off.
+// Unlike the tree, moves that end the turn go through a chance node over the energy the next player gets
+static int depthFirstSearch(Game& game, int depth, int ply, int turn, int alpha, int beta, SearchContext& context, Action& bestAction) {
+    const GameState& state = game.getGameState();
+    bestAction = Action(ActionType::END_TURN);
+    if (shouldAbort(context)) {
+        return 0;  // Discarded by the caller
+    }
+    if (turn >= context.maxTurns || state.gameOver) {
+        return evaluateGameState(state, context.currentPlayer);
+    }
+
+    MoveList moves = generateMoves(game, context);
+    if (moves.empty()) {
+        return evaluateGameState(state, context.currentPlayer);
+    }
+    if (depth == 0) {
+        context.depthLimited = true;
+        return evaluateGameState(state, context.currentPlayer);
+    }
+
+    const uint64_t key = nodeKey(state, turn, context);
+    const int alphaOriginal = alpha;
+    const int betaOriginal = beta;
+    Action tableMove = ply == 0 ? context.rootMove : Action(ActionType::ROOT);
+    int tableValue;
+    bool complete = true;
+    int entryDepth = 0;
+    if (probeTable(context.table, key, depth, horizonOf(turn, context), alpha, beta, tableMove, tableValue, complete, &entryDepth)) {
+        // Another thread or an earlier visit may have searched it, it still counts as cut off if its subtree was
+        context.depthLimited |= !complete;
+        if (ply == 0) {
+            context.rootTableDepth = entryDepth;
+        }
+        bestAction = tableMove;
+        return tableValue;
+    }
+
+    // Track depth cutoffs of this subtree on their own so the entry can record them. A stored bound that
+    // narrowed the window decides the result as much as the moves searched, and so do its cutoffs
+    const bool depthLimitedBefore = context.depthLimited;
+    context.depthLimited = (alpha != alphaOriginal || beta != betaOriginal) && !complete;
+
+    int order[MAX_MOVES];
+    orderMoves(state, moves.begin(), (int)moves.size(), tableMove, ply, context.heuristics, order);
+
+    const bool maximizingPlayer = state.currentPlayer == context.currentPlayer;
+    int bestEval = maximizingPlayer ? INT_MIN : INT_MAX;
+    bestAction = moves[order[0]];
+
+    for (int i = 0; i < (int)moves.size(); i++) {
+        const Action& action = moves[order[i]];
+        const int nextTurn = endsTurn(action) ? turn + 1 : turn;
+
+        int eval = searchMove(game, action, depth - 1, ply + 1, nextTurn, alpha, beta, context);
+        if (context.aborted) {
+            return 0;
+        }
+
+        if (maximizingPlayer ? eval > bestEval : eval < bestEval) {
+            bestEval = eval;
+            bestAction = action;
+        }
+        if (maximizingPlayer) {
+            alpha = max(alpha, eval);
+        }
+        else {
+            beta = min(beta, eval);
+        }
+
+        if (alpha >= beta) {
+            recordCutoff(context.heuristics, action, ply, depth);
+            break;
+        }
+    }
+
+    context.table.store(key, bestEval, depth, boundFor(bestEval, alphaOriginal, betaOriginal), bestAction, !context.depthLimited,
+        horizonOf(turn, context));
+    context.depthLimited |= depthLimitedBefore;
+    return bestEval;
+}
+
+pair<int, Action> searchBestAction(const GameState& position, int maxTurns, int depth, TranspositionTable& table) {
+    const GameState state = canonicalRoot(position);
+    Game game(state, true);
+    SearchContext context(table, state.currentPlayer, maxTurns);
+    Action bestAction;
+    int eval = depthFirstSearch(game, depth, 0, 0, INT_MIN, INT_MAX, context, bestAction);
+    return { eval, bestAction };
+}
+
+// Runs iterations from firstDepth up to limits.maxDepth on one thread, result keeps the last completed one
+static void deepen(Game& game, SearchContext& context, const SearchLimits& limits, int firstDepth, SearchResult& result) {
+    for (int depth = firstDepth; depth <= limits.maxDepth; depth++) {
+        context.depthLimited = false;
+        context.rootTableDepth = 0;
+        Action bestAction;
+        int eval = depthFirstSearch(game, depth, 0, 0, INT_MIN, INT_MAX, context, bestAction);
+
+        // An interrupted iteration is incomplete, keep the last completed one
+        if (context.aborted) {
+            break;
+        }
+
+        result.bestAction = bestAction;
+        result.value = eval;
+        // A root entry of another thread or an earlier search can hold a deeper result than this iteration
+        result.depth = max(depth, context.rootTableDepth);
+        context.rootMove = bestAction;
+
+        // Nothing was cut off by depth, so searching deeper would find the same
+        if (!context.depthLimited) {
+            break;
+        }
+    }
+}
+
+SearchResult iterativeDeepening(const GameState& position, const SearchLimits& limits, TranspositionTable& table) {
+    const GameState state = canonicalRoot(position);
+    Game game(state, true);
+    SearchContext context(table, state.currentPlayer, limits.maxTurns);
+    context.maxNodes = limits.maxNodes;
+    context.stop = limits.stop;
+    context.sharedNodes = limits.sharedNodes;
+    context.canonicalTurns = limits.canonicalTurns;
+    if (limits.timeLimitMs > 0) {
+        context.hasDeadline = true;
+        context.deadline = chrono::steady_clock::now() + chrono::milliseconds(limits.timeLimitMs);
+    }
+
+    // Fall back to a legal move in case not even the first iteration completes
+    MoveList rootMoves = generateMoves(game, context);
+    SearchResult result;
+    result.bestAction = rootMoves.empty() ? Action(ActionType::END_TURN) : rootMoves[0];
+
+    // Lazy SMP: helpers search the same root through the shared table, half of them one ply ahead, and
+    // fill it with results the main thread then only has to look up. Only the main thread's result is used.
+    // Helpers share the deadline and count their nodes against maxNodes, and stop when the main thread does
+    atomic<bool> helpersStop(false);
+    atomic<uint64_t> helperNodes(0);
+    atomic<uint64_t> threadNodes(0);
+    if (limits.threads > 1 && context.sharedNodes == nullptr) {
+        context.sharedNodes = &threadNodes;
+    }
+    vector<thread> helpers;
+    for (int h = 1; h < limits.threads; h++) {
+        helpers.emplace_back([&, h]() {
+            Game helperGame(state, true);
+            SearchContext helperContext(table, state.currentPlayer, limits.maxTurns);
+            helperContext.stop = &helpersStop;
+            helperContext.maxNodes = context.maxNodes;
+            helperContext.sharedNodes = context.sharedNodes;
+            helperContext.hasDeadline = context.hasDeadline;
+            helperContext.deadline = context.deadline;
+            helperContext.canonicalTurns = limits.canonicalTurns;
+            SearchResult helperResult;
+            deepen(helperGame, helperContext, limits, 1 + h % 2, helperResult);
+            helperNodes += helperContext.nodes;
+        });
+    }
+
+    deepen(game, context, limits, 1, result);
+
+    helpersStop = true;
+    for (thread& helper : helpers) {
+        helper.join();
+    }
+
+    result.nodes = context.nodes + helperNodes;
+    return result;
+}
+
+constexpr size_t PARALLEL_TABLE_MB = 4;  // Transposition table of each search thread
+
+// Value of one root move, gathered from the work units it was split into
+struct RootMoveResult {
+    mutex lock;
+    int remaining = 0;    // Work units still to finish
+    bool minimizing = false;
+    int value = 0;
+    bool refuted = false; // A reply already proved the move cannot beat the best move
+};
+
+// A root move, or one reply to a root move, searched by whichever thread picks it up
+struct WorkUnit {
+    int rootIndex;
+    int replyIndex;  // -1 searches the whole root move
+};
+
+pair<int, Action> parallelSearchBestAction(const GameState& position, int maxTurns, int depth, int threadCount) {
+    const GameState state = canonicalRoot(position);
+    Game rootGame(state, true);
+    const int currentPlayer = state.currentPlayer;
+    MoveList rootMoves = getCanonicalActions(rootGame);
+    if (threadCount <= 1 || depth <= 1 || maxTurns <= 0 || state.gameOver || rootMoves.empty()) {
+        TranspositionTable table(PARALLEL_TABLE_MB);
+        return searchBestAction(state, maxTurns, depth, table);
+    }
+
+    // Root moves in the order the serial search tries them, ties go to the earliest like they do there
+    SearchHeuristics noHeuristics;
+    int order[MAX_MOVES];
+    const int rootCount = (int)rootMoves.size();
+    orderMoves(state, rootMoves.begin(), rootCount, Action(ActionType::ROOT), 0, noHeuristics, order);
+
+    // With fewer root moves than threads, the replies to each root move become separate work units
+    vector<RootMoveResult> results(rootCount);
+    vector<MoveList> replies(rootCount);
+    vector<WorkUnit> units;
+    const bool splitReplies = rootCount < threadCount && depth > 2;
+    for (int r = 0; r < rootCount; r++) {
+        const Action& action = rootMoves[order[r]];
+        const int nextTurn = endsTurn(action) ? 1 : 0;
+
+        UndoRecord undo;
+        rootGame.makeAction(action, undo);
+        const GameState& child = rootGame.getGameState();
+        results[r].minimizing = child.currentPlayer != currentPlayer;
+        if (splitReplies && !endsTurn(action) && nextTurn < maxTurns && !child.gameOver) {
+            replies[r] = getCanonicalActions(rootGame);
+        }
+        rootGame.unmakeAction(undo);
+
+        if (replies[r].empty()) {
+            units.push_back({ r, -1 });
+            results[r].remaining = 1;
+            results[r].value = 0;
+        }
+        else {
+            for (int reply = 0; reply < (int)replies[r].size(); reply++) {
+                units.push_back({ r, reply });
+            }
+            results[r].remaining = (int)replies[r].size();
+            results[r].value = results[r].minimizing ? INT_MAX : INT_MIN;
+        }
+    }
+
+    // Best root value found so far, shared so every thread searches with the tightest window
+    atomic<int> bestValue(INT_MIN);
+    atomic<int> nextUnit(0);
+
+    auto worker = [&]() {
+        Game game(state, true);
+        TranspositionTable table(PARALLEL_TABLE_MB);
+        SearchContext context(table, currentPlayer, maxTurns);
+
+        for (int u = nextUnit++; u < (int)units.size(); u = nextUnit++) {
+            const WorkUnit& unit = units[u];
+            RootMoveResult& result = results[unit.rootIndex];
+            const Action& action = rootMoves[order[unit.rootIndex]];
+
+            // Alpha one below the best value keeps ties exact, so they resolve by move order as in the serial search
+            const int best = bestValue.load();
+            const int alpha = best == INT_MIN ? INT_MIN : best - 1;
+
+            int eval = 0;
+            bool skipped = false;
+            {
+                lock_guard<mutex> guard(result.lock);
+                skipped = result.refuted;
+            }
+
+            if (!skipped) {
+                const int turn = endsTurn(action) ? 1 : 0;
+                if (unit.replyIndex < 0) {
+                    eval = searchMove(game, action, depth - 1, 1, turn, alpha, INT_MAX, context);
+                }
+                else {
+                    // Only moves that keep the turn are split, so there is no chance node in between
+                    const Action& reply = replies[unit.rootIndex][unit.replyIndex];
+                    UndoRecord undo;
+                    game.makeAction(action, undo);
+                    eval = searchMove(game, reply, depth - 2, 2, endsTurn(reply) ? turn + 1 : turn, alpha, INT_MAX, context);
+                    game.unmakeAction(undo);
+                }
+            }
+
+            lock_guard<mutex> guard(result.lock);
+            if (!skipped) {
+                if (unit.replyIndex < 0) {
+                    result.value = eval;
+                }
+                else if (result.minimizing) {
+                    result.value = min(result.value, eval);
+                    result.refuted = result.value <= alpha;
+                }
+                else {
+                    result.value = max(result.value, eval);
+                }
+            }
+
+            // The last unit of a root move publishes its value
+            if (--result.remaining == 0) {
+                int current = bestValue.load();
+                while (result.value > current && !bestValue.compare_exchange_weak(current, result.value)) {
+                }
+            }
+        }
+    };
+
+    vector<thread> threads;
+    for (int t = 0; t < threadCount; t++) {
+        threads.emplace_back(worker);
+    }
+    for (thread& t : threads) {
+        t.join();
+    }
+
+    // Moves that failed low are strictly below the best value, so the first move reaching it is the serial choice
+    int bestIndex = 0;
+    for (int r = 1; r < rootCount; r++) {
+        if (results[r].value > results[bestIndex].value) {
+            bestIndex = r;
+        }
+    }
+    return { results[bestIndex].value, rootMoves[order[bestIndex]] };
+}
+
+Action findBestAction(const ActionNode* rootNode, int depth, int currentPlayer, TranspositionTable& table) {
+    return alphaBeta(rootNode, depth, INT_MIN, INT_MAX, currentPlayer, table).second;
+}
+
+Action findBestAction(const ActionNode* rootNode, int depth, int currentPlayer) {
+    // Values are relative to currentPlayer and the tree's horizon, so nothing carries over between calls
+    static TranspositionTable table;
+    table.clear();
+    return findBestAction(rootNode, depth, currentPlayer, table);
+}
+
+Action findBestAction(const GameState& state, int maxTurns, int depth) {
+    static TranspositionTable table;
+    table.clear();
+    return searchBestAction(state, maxTurns, depth, table).second;
+}
+
+Action findBestAction(const GameState& state, int maxTurns, int depth, int threadCount) {
+    return parallelSearchBestAction(state, maxTurns, depth, threadCount).second;
+}
+
+Action findBestAction(const GameState& state, const SearchLimits& limits) {
+    SearchLimits searchLimits = limits;
+    if (limits.endgame != nullptr && EndgameTable::qualifies(state)) {
+        // The solver gets half of each budget, the search whatever it leaves if it cannot prove a result
+        const auto start = chrono::steady_clock::now();
+        SearchLimits endgameLimits = limits;
+        endgameLimits.timeLimitMs = limits.timeLimitMs > 0 ? max<int64_t>(1, limits.timeLimitMs / 2) : 0;
+        endgameLimits.maxNodes = limits.maxNodes > 0 ? max<uint64_t>(1, limits.maxNodes / 2) : 0;
+        Action move = Action(ActionType::END_TURN);
+        if (limits.endgame->solve(state, endgameLimits, &move).result != EndgameResult::UNKNOWN) {
+            return move;
+        }
+        if (limits.timeLimitMs > 0) {
+            const int64_t elapsedMs = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+            searchLimits.timeLimitMs = max<int64_t>(1, limits.timeLimitMs - elapsedMs);
+        }
+        if (limits.maxNodes > 0) {
+            searchLimits.maxNodes = limits.maxNodes - min(limits.maxNodes - 1, limits.endgame->nodes());
+        }
+    }
+
+    // The table is kept between calls: within a turn the subtree of the move just played is already in it, so
+    // the iterations it covers are looked up. After the opponent's reply the new root's subtree was searched
+    // with fewer turns left, its entries only order the moves until the search overwrites them
+    static TranspositionTable table;
+    table.newSearch();
+    return iterativeDeepening(state, searchLimits, table).bestAction;
 }
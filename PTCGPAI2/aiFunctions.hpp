@@ -1,14 +1,73 @@
 #pragma once
 
 #include <memory>
+#include <atomic>
+#include <cstdint>
+
+#include "Action.hpp"
 
 //forward declarations
 struct GameState;
 struct Action;
 struct ActionNode;
+class TranspositionTable;
+class EndgameTable;
+
+// Budgets for one iterative-deepening search, a zero means no limit
+struct SearchLimits {
+    int maxDepth = 64;                        // Deepest iteration, in plies
+    int maxTurns = 4;                         // Turns to look ahead, as in buildActionTree
+    int64_t timeLimitMs = 0;                  // Wall-clock budget for the whole search
+    uint64_t maxNodes = 0;                    // Node budget for the whole search, helper threads included
+    const std::atomic<bool>* stop = nullptr;  // Set from another thread to stop the search early
+    int threads = 1;                          // Lazy SMP threads sharing the transposition table
+    std::atomic<uint64_t>* sharedNodes = nullptr;  // Makes maxNodes a budget shared by every search using this counter
+    bool canonicalTurns = true;               // Skip move orders that only differ in energy timing or in which copy was benched
+    EndgameTable* endgame = nullptr;          // Solves small positions exactly instead of searching them, used by findBestAction
+    int endgameTurns = 6;                     // Turns the endgame solver looks ahead
+};
+
+struct SearchResult {
+    Action bestAction = Action(ActionType::END_TURN);
+    int value = 0;
+    int depth = 0;       // Depth of the last completed iteration, or of the deeper table entry it was taken from, 0 if none completed
+    uint64_t nodes = 0;  // Nodes of all threads
+};
+
+int evaluateGameState(const GameState& state, int currentPlayer);
+
+// Plain minimax, the side to move in each node decides whether it is maximized for currentPlayer
+std::pair<int, Action> minimax(const ActionNode* node, int depth, bool maximizingPlayer, int currentPlayer, TranspositionTable& table);
+
+// Alpha-beta search with move ordering, returns the same value as minimax for a full window
+std::pair<int, Action> alphaBeta(const ActionNode* node, int depth, int alpha, int beta, int currentPlayer, TranspositionTable& table);
+
+// Searches with a table owned by the caller, the table must be cleared when the tree or player changes
+Action findBestAction(const ActionNode* rootNode, int depth, int currentPlayer, TranspositionTable& table);
+
+// Searches with a shared table that is cleared on every call
+Action findBestAction(const ActionNode* rootNode, int depth, int currentPlayer);
+
+// Alpha-beta that generates the children of each position on the fly instead of walking a tree built by
+// buildActionTree, so memory stays O(depth). Searches maxTurns turns ahead for the side to move, in canonical
+// turn order (see getCanonicalActions)
+std::pair<int, Action> searchBestAction(const GameState& state, int maxTurns, int depth, TranspositionTable& table);
+
+// Tree-free search with a shared table that is cleared on every call
+Action findBestAction(const GameState& state, int maxTurns, int depth);
+
+// Tree-free search split across threads by root move, or by reply when there are fewer root moves than
+// threads. Returns the same value and move as searchBestAction
+std::pair<int, Action> parallelSearchBestAction(const GameState& state, int maxTurns, int depth, int threadCount);
 
-int evaluateGameState(const std::shared_ptr<GameState>& state, int currentPlayer);
+Action findBestAction(const GameState& state, int maxTurns, int depth, int threadCount);
 
-std::pair<int, Action> minimax(std::shared_ptr<ActionNode> node, int depth, bool maximizingPlayer, int currentPlayer);
+// Searches 1, 2, 3... plies deep until a budget runs out, returns the result of the last completed iteration.
+// With limits.threads above 1, helper threads search the same root and share the table (Lazy SMP)
+SearchResult iterativeDeepening(const GameState& state, const SearchLimits& limits, TranspositionTable& table);
 
-Action findBestAction(std::shared_ptr<ActionNode> rootNode, int depth, int currentPlayer);
\ No newline at end of file
+// Iterative deepening with a table that is kept from call to call, so later moves of a turn reuse the search of
+// the earlier ones, and the next turn starts with the best moves found for its positions. Positions the endgame table qualifies are solved exactly first with half of the time and node
+// budgets, and searched with the rest if neither player can force a win within limits.endgameTurns or the solver
+// ran out
+Action findBestAction(const GameState& state, const SearchLimits& limits);
\ No newline at end of file
@@ -0,0 +1,77 @@
+#ifndef ENERGY_HPP
+#define ENERGY_HPP
+
+#include <cstdint>
+#include <string>
+
+using namespace std;
+
+// Attached energy stored as one 8-bit count per energy type, all packed into a single word
+using EnergyPool = uint64_t;
+
+constexpr int NUM_ENERGY_TYPES = 8;
+constexpr char ENERGY_TYPES[NUM_ENERGY_TYPES] = { 'G', 'F', 'W', 'L', 'P', 'I', 'D', 'M' };
+
+// Counts stay below 128 so a lane can never borrow from its neighbour in canAfford
+constexpr int MAX_ENERGY_PER_TYPE = 127;
+
+constexpr uint64_t ENERGY_LANE_ONES = 0x0101010101010101ull;
+constexpr uint64_t ENERGY_LANE_HIGH_BITS = 0x8080808080808080ull;
+
+// Lane of an energy type, or -1 for colorless 'X' and unknown types
+inline int energyTypeIndex(char type) {
+    switch (type) {
+    case 'G': return 0;
+    case 'F': return 1;
+    case 'W': return 2;
+    case 'L': return 3;
+    case 'P': return 4;
+    case 'I': return 5;
+    case 'D': return 6;
+    case 'M': return 7;
+    default: return -1;
+    }
+}
+
+// A pool holding a single energy of the given type
+inline EnergyPool energyUnit(char type) {
+    int index = energyTypeIndex(type);
+    return index < 0 ? 0 : 1ull << (8 * index);
+}
+
+inline int energyCount(EnergyPool pool, char type) {
+    int index = energyTypeIndex(type);
+    return index < 0 ? 0 : (int)((pool >> (8 * index)) & 0xFF);
+}
+
+// Sum of all lanes, valid while the total stays below 256
+inline int totalEnergy(EnergyPool pool) {
+    return (int)((pool * ENERGY_LANE_ONES) >> 56);
+}
+
+// Attack cost precompiled into the same packed layout as the attached energy
+struct EnergyCost {
+    EnergyPool typed = 0;     // Required count per energy type
+    uint8_t colorless = 0;    // 'X' energy, payable with any type
+    uint8_t total = 0;        // Typed plus colorless
+};
+
+// Every typed lane must cover its requirement and the total must cover the colorless remainder
+inline bool canAfford(EnergyPool pool, const EnergyCost& cost) {
+    // Setting the high bit of every lane before subtracting leaves it set only where pool >= cost
+    if ((((pool | ENERGY_LANE_HIGH_BITS) - cost.typed) & ENERGY_LANE_HIGH_BITS) != ENERGY_LANE_HIGH_BITS) {
+        return false;
+    }
+    return totalEnergy(pool) >= cost.total;
+}
+
+// Energy of a pool written out type by type, e.g. "GGI"
+inline string energyToString(EnergyPool pool) {
+    string energy;
+    for (char type : ENERGY_TYPES) {
+        energy.append(energyCount(pool, type), type);
+    }
+    return energy;
+}
+
+#endif // ENERGY_HPP
@@ -11,11 +11,13 @@
 
 #include "types.hpp"
 #include "deck.hpp"
+#include "CardTable.hpp"
 #include "utilities.hpp"
 #include "Game.hpp"
 #include "Action.hpp"
 #include "GameState.hpp"
 #include "aiFunctions.hpp"
+#include "Endgame.hpp"
 
 using namespace std;
 
@@ -24,6 +26,7 @@ int main() {
     //runScraper();
     CardCollection cardCollection;
     readCSVAndPopulateDeck("pokemon_cards.csv", cardCollection);  // Adjust the reading function accordingly
+    CardTable::build(cardCollection);  // Intern the cards so the engine can refer to them by ID
     //cardCollection.displayCollection();  // Display all the cards
 
     // Manually create another two decks
@@ -64,19 +67,37 @@ int main() {
     shared_ptr<Deck> manualDeck1Ptr = make_shared<Deck>(manualDeck1);
     shared_ptr<Deck> manualDeck2Ptr = make_shared<Deck>(manualDeck2);
 
-    Game manualGame(manualDeck1Ptr, manualDeck2Ptr);
+    // The interactive game records what happens, the loop prints it between moves
+    VerboseGame manualGame(manualDeck1Ptr, manualDeck2Ptr);
+    printEvents(manualGame.getLog());
+
+    // Search 4 turns ahead, but never spend more than a second on a move
+    SearchLimits limits;
+    limits.maxTurns = 4;
+    limits.maxDepth = 20;
+    limits.timeLimitMs = 1000;
+
+    // Small endgames are solved exactly, and the solved positions are kept between runs
+    EndgameTable endgame;
+    endgame.load("endgame.bin");
+    limits.endgame = &endgame;
+
+    // The search does not build the action tree, use buildActionTree to inspect it.
+    // The tree is reset for every move, which keeps its memory for the next one
+    //ActionTree tree;
 
     int i = 0;
     cout << "\n\n!-!-!-!-!-!-!-!-!-!-!-!-!-!-!-!-!-!-!-!\n\n" << endl;
     cout << "Turn " << i + 1 << endl;
     while (i < 20 && !manualGame.isWinner()) {
-        shared_ptr<ActionNode> root = make_shared<ActionNode>(manualGame.getGameState(), Action(ActionType::ROOT));
-        buildActionTree(root, 4, 0, manualGame.getValidActions());
+        //ActionNode* root = tree.reset(manualGame.getGameState());
+        //buildActionTree(tree, root, 4, 0, manualGame.getValidActions());
         //displayActionTree(root);
-        Action bestAction = findBestAction(root, 20, manualGame.getGameState()->currentPlayer);
+        Action bestAction = findBestAction(manualGame.getGameState(), limits);
         
         cout << "\n";
         applyAction(manualGame, bestAction);
+        printEvents(manualGame.getLog());
         if ((bestAction.type == ActionType::END_TURN || bestAction.type == ActionType::ATTACK) && !manualGame.isWinner()) {
             displayGameState(manualGame.getGameState());
             cout << "\n\n!-!-!-!-!-!-!-!-!-!-!-!-!-!-!-!-!-!-!-!\n\n" << endl;
@@ -85,5 +106,7 @@ int main() {
         }
     }
 
+    endgame.save("endgame.bin");
+
     return 0;
 }
\ No newline at end of file
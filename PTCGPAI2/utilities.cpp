@@ -107,8 +107,9 @@ void readCSVAndPopulateDeck(const string& filename, CardCollection& cardCollecti
             attacks.push_back(attack2);
         }
 
-        // Create the card object
-        Card card(cardName, 0, hp, type, stage, attacks, 0, weakness, retreatCost);
+        // Create the card object, IDs are dense and follow the order of the collection
+        int cardID = (int)cardCollection.getCardCount();
+        Card card(cardName, cardID, hp, type, stage, attacks, 0, weakness, retreatCost);
 
         // Add the card to the deck
         cardCollection.addCard(card);
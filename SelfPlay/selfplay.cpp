@@ -0,0 +1,346 @@
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "types.hpp"
+#include "deck.hpp"
+#include "CardTable.hpp"
+#include "utilities.hpp"
+#include "SelfPlay.hpp"
+#include "Tournament.hpp"
+#include "Endgame.hpp"
+#include "Game.hpp"
+#include "Action.hpp"
+#include "Zobrist.hpp"
+#include "Evaluation.hpp"
+#include "TranspositionTable.hpp"
+#include "aiFunctions.hpp"
+
+using namespace std;
+
+// Headless batch runner: plays engine against engine between two decks and reports the aggregate results,
+// or plays every deck of a deck list against every other one. --check runs the engine's consistency checks
+
+static void printUsage() {
+    cout << "Usage: SelfPlay [options]\n"
+        << "  --check           Runs the engine's consistency checks and exits\n"
+        << "  --cards file      Card list to read decks from (default pokemon_cards.csv)\n"
+        << "  --deck1 names     Comma-separated card names of the first deck\n"
+        << "  --deck2 names     Comma-separated card names of the second deck\n"
+        << "  --games N         Games to play (default 100)\n"
+        << "  --threads N       Games played at the same time, 0 for every core (default 0)\n"
+        << "  --max-turns N     Turns after which a game counts as unfinished (default 50)\n"
+        << "  --look-ahead N    Turns each move searches ahead (default 2)\n"
+        << "  --nodes N         Node budget of each move, 0 for none (default 20000)\n"
+        << "  --time ms         Time budget of each move, 0 for none (default 0)\n"
+        << "  --seed N          Seed of the games, 0 for a random one (default 0)\n"
+        << "  --tournament file Plays every deck of the list against every other one, --games per pairing and seat\n"
+        << "  --cache file      Results of earlier tournaments, only new pairings are played (default tournament.bin)\n"
+        << "  --matrix file     Writes the win rate of every deck against every other one as CSV\n";
+}
+
+// Function to place a Pokemon with the given HP and G energy, for the check positions
+static ActivePokemon checkPokemon(const CardCollection& cardCollection, const string& name, int hp, int energy) {
+    ActivePokemon pokemon;
+    pokemon.card = (CardID)cardCollection.findCardByName(name)->cardID;
+    pokemon.currentHP = (int16_t)hp;
+    for (int e = 0; e < energy; e++) {
+        pokemon.addEnergy('G');
+    }
+    return pokemon;
+}
+
+// The endgame table must keep positions apart that only differ in bench order: player 2's active Caterpie is
+// knocked out for player 1's second point and bench slot 1 takes over. A charged Scyther there knocks out
+// player 1's last Pokemon, a Caterpie there cannot hurt it and falls next turn for the third point
+static bool checkEndgameBenchOrder(const CardCollection& cardCollection) {
+    if (!cardCollection.findCardByName("Scyther") || !cardCollection.findCardByName("Caterpie")) {
+        cout << "Endgame bench order: skipped, Scyther and Caterpie are not in the card list" << endl;
+        return true;
+    }
+
+    GameState states[2];
+    for (int order = 0; order < 2; order++) {
+        GameState& state = states[order];
+        state.currentPlayer = 0;
+        state.playerPoints[0] = 1;
+        for (int player = 0; player < 2; player++) {
+            state.playerEnergyTypes[player][0] = 'G';
+            state.playerEnergyTypeCount[player] = 1;
+        }
+        state.playerActiveSpots[0] = checkPokemon(cardCollection, "Scyther", 10, 1);
+        state.playerActiveSpots[1] = checkPokemon(cardCollection, "Caterpie", 10, 0);
+        state.playerBenchSpots[1][order] = checkPokemon(cardCollection, "Scyther", 70, 1);
+        state.playerBenchSpots[1][1 - order] = checkPokemon(cardCollection, "Caterpie", 10, 0);
+        state.playerBenchSize[1] = 2;
+    }
+
+    EndgameTable table;
+    const EndgameResult charged = table.solve(states[0], 4).result;
+    const EndgameResult harmless = table.solve(states[1], 4).result;
+    const bool passed = EndgameTable::canonicalKey(states[0]) != EndgameTable::canonicalKey(states[1])
+        && charged != EndgameResult::WIN && harmless == EndgameResult::WIN;
+    cout << "Endgame bench order: " << (passed ? "passed" : "FAILED") << endl;
+    return passed;
+}
+
+const uint64_t CHECK_SEED = 0x5EED;
+const int CHECK_GAMES = 20;
+const int CHECK_MAX_ACTIONS = 200;
+const int CHECK_SEARCH_GAMES = 10;
+const int CHECK_SEARCH_INTERVAL = 4;  // Actions between two searched positions
+const int CHECK_SEARCH_TURNS = 3;
+const int CHECK_SEARCH_DEPTH = 8;
+const int CHECK_SEARCH_THREADS = 4;
+
+// Every move of every position of a few random games is made and taken back: the incremental Zobrist key and
+// evaluation must equal a full recompute after the move, and unmakeAction must restore the state byte for byte.
+// Turn-ending moves are made once for each energy type the next player can be given
+static bool checkMakeUnmake(const shared_ptr<Deck> decks[2]) {
+    Rng rng(CHECK_SEED);
+    uint64_t moves = 0;
+    uint64_t failures = 0;
+
+    for (int g = 0; g < CHECK_GAMES; g++) {
+        Game game(decks[0], decks[1], Rng(CHECK_SEED, g));
+        for (int step = 0; step < CHECK_MAX_ACTIONS && !game.isWinner(); step++) {
+            const MoveList legal = getLegalActions(game);
+            if (legal.empty()) {
+                break;
+            }
+            const GameState before = game.getGameState();
+            const int energyTypes = before.playerEnergyTypeCount[1 - before.currentPlayer];
+
+            for (const Action& action : legal) {
+                const bool drawsEnergy = endsTurn(action) && energyTypes > 0;
+                for (int outcome = 0; outcome < (drawsEnergy ? energyTypes : 1); outcome++) {
+                    if (drawsEnergy) {
+                        game.setEnergyOutcome(outcome);
+                    }
+                    UndoRecord undo;
+                    game.makeAction(action, undo);
+                    const GameState& after = game.getGameState();
+                    if (after.zobristKey != Zobrist::computeKey(after) || after.evaluation != Evaluation::computeScore(after)) {
+                        failures++;
+                    }
+                    game.unmakeAction(undo);
+                    if (memcmp(&before, &game.getGameState(), sizeof(GameState)) != 0) {
+                        failures++;
+                    }
+                    moves++;
+                }
+            }
+            applyAction(game, legal[rng.below((uint32_t)legal.size())]);
+        }
+    }
+
+    cout << "Make/unmake and incremental keys: " << (failures == 0 ? "passed" : "FAILED")
+        << " (" << moves << " moves, " << failures << " failures)" << endl;
+    return failures == 0;
+}
+
+// The threaded searches must find the same value as the serial ones: parallelSearchBestAction against
+// searchBestAction at a fixed depth, and Lazy SMP against a single thread. The searches end at the horizon
+// long before maxDepth, so neither is cut short and the values can be compared exactly
+static bool checkParallelSearch(const shared_ptr<Deck> decks[2]) {
+    Rng rng(CHECK_SEED);
+    int positions = 0;
+    int failures = 0;
+
+    for (int g = 0; g < CHECK_SEARCH_GAMES; g++) {
+        Game game(decks[0], decks[1], Rng(CHECK_SEED, CHECK_GAMES + g));
+        for (int step = 0; step < CHECK_MAX_ACTIONS && !game.isWinner(); step++) {
+            const MoveList legal = getLegalActions(game);
+            if (legal.empty()) {
+                break;
+            }
+            if (step % CHECK_SEARCH_INTERVAL == 0) {
+                const GameState& state = game.getGameState();
+                TranspositionTable serialTable;
+                const int serial = searchBestAction(state, CHECK_SEARCH_TURNS, CHECK_SEARCH_DEPTH, serialTable).first;
+                const int parallel = parallelSearchBestAction(state, CHECK_SEARCH_TURNS, CHECK_SEARCH_DEPTH, CHECK_SEARCH_THREADS).first;
+
+                SearchLimits limits;
+                limits.maxTurns = CHECK_SEARCH_TURNS;
+                TranspositionTable singleTable;
+                const int single = iterativeDeepening(state, limits, singleTable).value;
+                limits.threads = CHECK_SEARCH_THREADS;
+                TranspositionTable sharedTable;
+                const int lazy = iterativeDeepening(state, limits, sharedTable).value;
+
+                positions++;
+                if (serial != parallel || single != lazy) {
+                    failures++;
+                }
+            }
+            applyAction(game, legal[rng.below((uint32_t)legal.size())]);
+        }
+    }
+
+    cout << "Parallel search: " << (failures == 0 ? "passed" : "FAILED")
+        << " (" << positions << " positions, " << failures << " failures)" << endl;
+    return failures == 0;
+}
+
+static void printRate(const string& label, int successes, int trials) {
+    const ConfidenceInterval interval = wilsonInterval(successes, trials);
+    cout << left << setw(20) << label << right << setw(6) << successes << "  "
+        << fixed << setprecision(1) << setw(5) << (trials > 0 ? 100.0 * successes / trials : 0.0) << "%"
+        << "  95% CI [" << setw(5) << 100.0 * interval.low << "%, " << setw(5) << 100.0 * interval.high << "%]" << endl;
+}
+
+// Function to write the matchup matrix: row deck's win rate against the column deck over both seats
+static bool writeMatrix(const string& path, const vector<TournamentDeck>& decks, const TournamentResult& result) {
+    ofstream file(path);
+    if (!file) {
+        return false;
+    }
+    file << "deck";
+    for (const TournamentDeck& deck : decks) {
+        file << "," << deck.name;
+    }
+    file << "\n" << fixed << setprecision(4);
+    for (int a = 0; a < result.deckCount; a++) {
+        file << decks[a].name;
+        for (int b = 0; b < result.deckCount; b++) {
+            file << ",";
+            if (a != b) {
+                file << result.winRate(a, b);
+            }
+        }
+        file << "\n";
+    }
+    return (bool)file;
+}
+
+static int runTournamentMode(const CardCollection& cardCollection, const string& deckList, const string& cachePath,
+    const string& matrixPath, const SelfPlayOptions& options) {
+    vector<TournamentDeck> decks;
+    if (!loadDeckList(deckList, cardCollection, decks)) {
+        return 1;
+    }
+    if (decks.size() < 2) {
+        cout << "A tournament needs at least two decks" << endl;
+        return 1;
+    }
+
+    TournamentCache cache;
+    cache.load(cachePath);
+    const TournamentResult result = runTournament(decks, options, cache, cachePath);
+
+    // Decks ranked by their games won against the whole field
+    vector<int> order(decks.size());
+    vector<int> wins(decks.size(), 0);
+    vector<int> games(decks.size(), 0);
+    for (int a = 0; a < result.deckCount; a++) {
+        order[a] = a;
+        for (int b = 0; b < result.deckCount; b++) {
+            if (a != b) {
+                wins[a] += result.wins(a, b);
+                games[a] += result.games(a, b);
+            }
+        }
+    }
+    stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        return (int64_t)wins[a] * games[b] > (int64_t)wins[b] * games[a];
+        });
+
+    for (int a : order) {
+        printRate(decks[a].name, wins[a], games[a]);
+    }
+    cout << "\nDecks: " << decks.size() << "  Pairings played: " << result.played << "  Cached: " << result.cached << "\n"
+        << "Time: " << fixed << setprecision(2) << result.seconds << " s\n"
+        << "Seed: " << result.seed << endl;
+
+    if (!matrixPath.empty() && !writeMatrix(matrixPath, decks, result)) {
+        cout << "Cannot write " << matrixPath << endl;
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    string cardsFile = "pokemon_cards.csv";
+    string deckNames[2] = { "Hitmonchan,Hitmonchan,Rhyhorn,Hitmontop,Farfetchd,Farfetchd",
+                            "Scyther,Scyther,Bulbasaur,Bulbasaur,Farfetchd,Farfetchd" };
+    string deckList;
+    string cachePath = "tournament.bin";
+    string matrixPath;
+    SelfPlayOptions options;
+    bool check = false;
+
+    for (int i = 1; i < argc; i++) {
+        const string arg = argv[i];
+        if (arg == "--check") {
+            check = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            printUsage();
+            return 1;
+        }
+        const string value = argv[++i];
+        if (arg == "--cards") cardsFile = value;
+        else if (arg == "--deck1") deckNames[0] = value;
+        else if (arg == "--deck2") deckNames[1] = value;
+        else if (arg == "--games") options.games = stoi(value);
+        else if (arg == "--threads") options.threads = stoi(value);
+        else if (arg == "--max-turns") options.maxGameTurns = stoi(value);
+        else if (arg == "--look-ahead") options.limits.maxTurns = stoi(value);
+        else if (arg == "--nodes") options.limits.maxNodes = stoull(value);
+        else if (arg == "--time") options.limits.timeLimitMs = stoll(value);
+        else if (arg == "--seed") options.seed = stoull(value);
+        else if (arg == "--tournament") deckList = value;
+        else if (arg == "--cache") cachePath = value;
+        else if (arg == "--matrix") matrixPath = value;
+        else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    CardCollection cardCollection;
+    readCSVAndPopulateDeck(cardsFile, cardCollection);
+    CardTable::build(cardCollection);
+
+    if (!check && !deckList.empty()) {
+        return runTournamentMode(cardCollection, deckList, cachePath, matrixPath, options);
+    }
+
+    shared_ptr<Deck> decks[2];
+    for (int d = 0; d < 2; d++) {
+        decks[d] = buildDeck(cardCollection, splitCardNames(deckNames[d]));
+        if (!decks[d]) {
+            cout << "Deck " << d + 1 << " is not valid: " << deckNames[d] << endl;
+            return 1;
+        }
+    }
+
+    if (check) {
+        const bool endgame = checkEndgameBenchOrder(cardCollection);
+        const bool makeUnmake = checkMakeUnmake(decks);
+        const bool parallel = checkParallelSearch(decks);
+        return endgame && makeUnmake && parallel ? 0 : 1;
+    }
+
+    SelfPlayResult result = runSelfPlay(decks[0], decks[1], options);
+
+    cout << "Deck 1: " << deckNames[0] << "\n"
+        << "Deck 2: " << deckNames[1] << "\n\n";
+    printRate("Deck 1 wins", result.wins[0], result.games);
+    printRate("Deck 2 wins", result.wins[1], result.games);
+    printRate("Unfinished", result.unfinished, result.games);
+    printRate("First player wins", result.firstPlayerWins, result.games - result.unfinished);
+    cout << "\nGames: " << result.games
+        << "  Average length: " << setprecision(1) << result.averageTurns() << " turns, "
+        << (result.games > 0 ? (double)result.totalActions / result.games : 0.0) << " actions\n"
+        << "Time: " << setprecision(2) << result.seconds << " s  Throughput: " << result.gamesPerSecond() << " games/sec\n"
+        << "Seed: " << result.seed << endl;
+
+    return 0;
+}